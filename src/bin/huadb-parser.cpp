@@ -27,14 +27,35 @@ void parse_control(const fs::path &path) {
   huadb::lsn_t lsn;
   huadb::oid_t oid;
   bool normal_shutdown;
+  size_t page_size = huadb::DEFAULT_PAGE_SIZE, buffer_size = huadb::DEFAULT_BUFFER_SIZE;
+  size_t systable_buffer_size = huadb::DEFAULT_SYSTABLE_BUFFER_SIZE;
   file >> xid >> lsn >> oid >> normal_shutdown;
+  // 旧版本控制文件中不存在的字段使用默认值
+  if (!(file >> page_size >> buffer_size)) {
+    page_size = huadb::DEFAULT_PAGE_SIZE;
+    buffer_size = huadb::DEFAULT_BUFFER_SIZE;
+  }
+  if (!(file >> systable_buffer_size)) {
+    systable_buffer_size = huadb::DEFAULT_SYSTABLE_BUFFER_SIZE;
+  }
+  std::string io_method = "sync";
+  size_t io_depth = huadb::DEFAULT_IO_DEPTH;
+  if (!(file >> io_method >> io_depth)) {
+    io_method = "sync";
+    io_depth = huadb::DEFAULT_IO_DEPTH;
+  }
   std::cout << "next xid: " << xid << std::endl;
   std::cout << "next lsn: " << lsn << std::endl;
   std::cout << "next oid: " << oid << std::endl;
   std::cout << "normal_shutdown: " << normal_shutdown << std::endl;
+  std::cout << "page_size: " << page_size << std::endl;
+  std::cout << "buffer_pool_size: " << buffer_size << std::endl;
+  std::cout << "systable_buffer_pool_size: " << systable_buffer_size << std::endl;
+  std::cout << "io_method: " << io_method << std::endl;
+  std::cout << "io_depth: " << io_depth << std::endl;
 }
 
-void parse_data(const fs::path &path) {
+void parse_data(const fs::path &path, size_t page_size) {
   if (!fs::is_regular_file(path)) {
     std::cerr << "File not found: " << path << std::endl;
     std::exit(1);
@@ -44,19 +65,19 @@ void parse_data(const fs::path &path) {
     std::cerr << "Failed to open file: " << path << std::endl;
     std::exit(1);
   }
-  char buffer[huadb::DB_PAGE_SIZE];
+  auto buffer = std::make_unique<char[]>(page_size);
   huadb::pageid_t page_id = 0;
   while (!file.eof()) {
-    file.read(buffer, huadb::DB_PAGE_SIZE);
+    file.read(buffer.get(), page_size);
     if (file.gcount() == 0) {
       break;
     }
-    if (file.gcount() != huadb::DB_PAGE_SIZE) {
+    if (file.gcount() != static_cast<std::streamsize>(page_size)) {
       std::cerr << "Incorrect page size" << std::endl;
       std::exit(1);
     }
-    auto page = std::make_unique<huadb::Page>();
-    memcpy(page->GetData(), buffer, huadb::DB_PAGE_SIZE);
+    auto page = std::make_shared<huadb::Page>(page_size);
+    memcpy(page->GetData(), buffer.get(), page_size);
     huadb::TablePage table_page(std::move(page));
     std::cout << "page id: " << page_id << std::endl;
     std::cout << table_page.ToString() << std::endl;
@@ -117,6 +138,10 @@ int main(int argc, char *argv[]) {
   program.add_argument("-c", "--control").flag();
   program.add_argument("-d", "--data").flag();
   program.add_argument("-l", "--log").flag();
+  program.add_argument("-p", "--page-size")
+      .help("Page size of the data file")
+      .default_value(huadb::DEFAULT_PAGE_SIZE)
+      .scan<'u', size_t>();
   program.add_argument("path").nargs(1).default_value(std::string(huadb::BASE_PATH));
   try {
     program.parse_args(argc, argv);
@@ -144,7 +169,12 @@ int main(int argc, char *argv[]) {
   if (mode == ParseMode::CONTROL) {
     parse_control(path);
   } else if (mode == ParseMode::DATA) {
-    parse_data(path);
+    auto page_size = program.get<size_t>("-p");
+    if (!huadb::IsValidPageSize(page_size)) {
+      std::cerr << "Invalid page size " << page_size << std::endl;
+      std::exit(1);
+    }
+    parse_data(path, page_size);
   } else {
     parse_log(path);
   }
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <thread>
 
+#include "argparse/argparse.hpp"
 #include "common/constants.h"
 #include "common/result_writer.h"
 #include "database/connection.h"
@@ -56,10 +57,28 @@ void client_handler(int client_socket, huadb::DatabaseEngine &database) {
   std::cout << "Client disconnected" << std::endl;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+  argparse::ArgumentParser program("server");
+  program.add_argument("--page-size")
+      .help("Page size used when creating the database (256, 4096, 8192 or 16384)")
+      .default_value(size_t{0})
+      .scan<'u', size_t>();
+  program.add_argument("--buffer-pool-size")
+      .help("Number of pages cached in the buffer pool")
+      .default_value(size_t{0})
+      .scan<'u', size_t>();
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::exception &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    std::exit(1);
+  }
+
   signal(SIGINT, sigint_handler);
 
-  auto database = std::make_unique<huadb::DatabaseEngine>();
+  auto database = std::make_unique<huadb::DatabaseEngine>(program.get<size_t>("--page-size"),
+                                                          program.get<size_t>("--buffer-pool-size"));
 
   int server_socket = socket(AF_UNIX, SOCK_STREAM, 0);
   if (server_socket == -1) {
@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "argparse/argparse.hpp"
 #include "common/constants.h"
 #include "common/result_writer.h"
 #include "database/connection.h"
@@ -12,9 +13,9 @@
 
 namespace fs = std::filesystem;
 
-void PlainShell() {
+void PlainShell(size_t page_size, size_t buffer_size) {
   std::string query;
-  auto database = std::make_unique<huadb::DatabaseEngine>();
+  auto database = std::make_unique<huadb::DatabaseEngine>(page_size, buffer_size);
   auto connection = std::make_unique<huadb::Connection>(*database);
   while (std::getline(std::cin, query)) {
     try {
@@ -42,7 +43,7 @@ void PlainShell() {
   }
 }
 
-void LinenoiseShell() {
+void LinenoiseShell(size_t page_size, size_t buffer_size) {
   std::string history_file;
   auto *home_dir = getenv("HOME");
   if (home_dir != nullptr) {
@@ -53,7 +54,7 @@ void LinenoiseShell() {
   linenoiseHistoryLoad(history_file.c_str());
   linenoiseHistorySetMaxLen(2048);
   linenoiseSetMultiLine(1);
-  auto database = std::make_unique<huadb::DatabaseEngine>();
+  auto database = std::make_unique<huadb::DatabaseEngine>(page_size, buffer_size);
   auto connection = std::make_unique<huadb::Connection>(*database);
   while (true) {
     auto current_db = connection->GetCurrentDatabase();
@@ -109,11 +110,31 @@ void LinenoiseShell() {
 }
 
 int main(int argc, char *argv[]) {
+  argparse::ArgumentParser program("shell");
+  program.add_argument("-s", "--simple").help("Read queries from stdin without line editing").flag();
+  program.add_argument("--page-size")
+      .help("Page size used when creating the database (256, 4096, 8192 or 16384)")
+      .default_value(size_t{0})
+      .scan<'u', size_t>();
+  program.add_argument("--buffer-pool-size")
+      .help("Number of pages cached in the buffer pool")
+      .default_value(size_t{0})
+      .scan<'u', size_t>();
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::exception &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    std::exit(1);
+  }
+  auto page_size = program.get<size_t>("--page-size");
+  auto buffer_size = program.get<size_t>("--buffer-pool-size");
+
   std::cout << R"(Welcome to HuaDB. Type "\?" or "\h" for help.)" << std::endl;
-  if (argc > 1 && strcmp(argv[1], "-s") == 0) {
-    PlainShell();
+  if (program.get<bool>("-s")) {
+    PlainShell(page_size, buffer_size);
   } else {
-    LinenoiseShell();
+    LinenoiseShell(page_size, buffer_size);
   }
   return 0;
 }
@@ -10,12 +10,14 @@ namespace huadb {
 ColumnList::ColumnList(const std::vector<ColumnDefinition> &columns) {
   for (const auto &column : columns) {
     col2idx_[column.name_] = col2idx_.size();
+    AddToLayout(column);
     columns_.push_back(column);
   }
 }
 
 void ColumnList::AddColumn(ColumnDefinition column) {
   col2idx_[column.name_] = col2idx_.size();
+  AddToLayout(column);
   columns_.push_back(std::move(column));
 }
 
@@ -72,6 +74,35 @@ void ColumnList::FromString(const std::string &str) {
   for (auto i = 0; i < columns_.size(); ++i) {
     col2idx_[columns_[i].name_] = i;
   }
+  layout_positions_.clear();
+  fixed_columns_.clear();
+  varlen_columns_.clear();
+  fixed_size_ = 0;
+  for (const auto &column : columns_) {
+    AddToLayout(column);
+  }
+}
+
+bool ColumnList::IsFixedLength(size_t index) const { return !TypeUtil::IsString(columns_[index].type_); }
+
+db_size_t ColumnList::GetLayoutPosition(size_t index) const { return layout_positions_[index]; }
+
+db_size_t ColumnList::GetFixedSize() const { return fixed_size_; }
+
+const std::vector<size_t> &ColumnList::GetFixedColumns() const { return fixed_columns_; }
+
+const std::vector<size_t> &ColumnList::GetVarlenColumns() const { return varlen_columns_; }
+
+void ColumnList::AddToLayout(const ColumnDefinition &column) {
+  // 调用时新列尚未加入 columns_，其下标为 layout_positions_.size()
+  if (TypeUtil::IsString(column.type_)) {
+    layout_positions_.push_back(varlen_columns_.size());
+    varlen_columns_.push_back(layout_positions_.size() - 1);
+  } else {
+    layout_positions_.push_back(fixed_size_);
+    fixed_columns_.push_back(layout_positions_.size() - 1);
+    fixed_size_ += column.max_size_;
+  }
 }
 
 }  // namespace huadb
@@ -40,10 +40,32 @@ namespace huadb {
         // 字符串格式反序列化
         void FromString(const std::string &str);
 
+        // 记录中定长列在前、变长列在后，各自保持列的原有顺序
+        bool IsFixedLength(size_t index) const;
+
+        // 定长列：之前的定长列均非空时，该列在定长区中的偏移；变长列：该列在变长列中的序号
+        db_size_t GetLayoutPosition(size_t index) const;
+
+        // 定长区的总长度（所有定长列均非空时）
+        db_size_t GetFixedSize() const;
+
+        // 按记录中的存放顺序排列的定长列与变长列下标
+        const std::vector<size_t> &GetFixedColumns() const;
+
+        const std::vector<size_t> &GetVarlenColumns() const;
+
     private:
+        // 在记录布局中追加一列
+        void AddToLayout(const ColumnDefinition &column);
+
         std::vector<ColumnDefinition> columns_;
         // 列名到列索引的映射表
         std::unordered_map<std::string, size_t> col2idx_;
+        // 记录布局，随列一起构建
+        std::vector<db_size_t> layout_positions_;
+        std::vector<size_t> fixed_columns_;
+        std::vector<size_t> varlen_columns_;
+        db_size_t fixed_size_ = 0;
     };
 
 }  // namespace huadb
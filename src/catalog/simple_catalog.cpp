@@ -1,6 +1,7 @@
 #include "catalog/simple_catalog.h"
 
 #include <cassert>
+#include <fstream>
 #include <string>
 
 #include "common/constants.h"
@@ -121,6 +122,11 @@ void SimpleCatalog::DropTable(const std::string &table_name) {
   // Step2. 实际删除表
   // 磁盘中删除对应项
   Disk::RemoveFile(Disk::GetFilePath(current_database_oid_, table_oid));
+  Disk::RemoveFile(Disk::GetFsmPath(current_database_oid_, table_oid));
+  buffer_pool_.CloseFile(current_database_oid_, table_oid);
+  Disk::RemoveFile(Disk::GetFilePath(current_database_oid_, GetToastOid(table_oid)));
+  Disk::RemoveFile(Disk::GetFsmPath(current_database_oid_, GetToastOid(table_oid)));
+  buffer_pool_.CloseFile(current_database_oid_, GetToastOid(table_oid));
   name2oid_.erase(table_name);
   oid2table_.erase(table_oid);
 
@@ -169,7 +175,7 @@ const ColumnList &SimpleCatalog::GetTableColumnList(const std::string &table_nam
   return GetTable(oid)->GetColumnList();
 }
 
-bool SimpleCatalog::TableExists(oid_t oid) const { return oid_manager_.OidExists(oid); }
+bool SimpleCatalog::TableExists(oid_t oid) const { return oid_manager_.OidExists(GetToastOwnerOid(oid)); }
 
 oid_t SimpleCatalog::GetNextOid() const { return oid_manager_.GetNextOid(); }
 
@@ -183,4 +189,10 @@ void SimpleCatalog::SetCardinality(const std::string &table_name, uint32_t cardi
 
 void SimpleCatalog::SetDistinct(const std::string &table_name, const std::string &column_name, uint32_t distinct) {}
 
+void SimpleCatalog::SaveFreeSpaceMaps() {
+  for (const auto &[oid, table] : oid2table_) {
+    table->SaveFreeSpaceMap();
+  }
+}
+
 }  // namespace huadb
@@ -63,6 +63,8 @@ class SimpleCatalog {
   // 设置统计信息
   void SetCardinality(const std::string &table_name, uint32_t cardinality);
   void SetDistinct(const std::string &table_name, const std::string &column_name, uint32_t distinct);
+  // 保存已加载的表的空闲空间映射
+  void SaveFreeSpaceMaps();
 
  private:
   BufferPool &buffer_pool_;
@@ -111,6 +111,7 @@ namespace huadb {
         if (Disk::DirectoryExists(std::to_string(db_oid))) {
             Disk::RemoveDirectory(std::to_string(db_oid));
         }
+        buffer_pool_.CloseFile(db_oid);
     }
 
     std::vector<std::string> SystemCatalog::GetDatabaseNames() const {
@@ -156,6 +157,8 @@ namespace huadb {
     }
 
     oid_t SystemCatalog::GetDatabaseOid(oid_t table_oid) const {
+        // TOAST 关系与所属表位于同一数据库
+        table_oid = GetToastOwnerOid(table_oid);
         if (oid2table_.find(table_oid) != oid2table_.end()) {
             return current_database_oid_;
         }
@@ -226,6 +229,11 @@ namespace huadb {
         // Step 2. 实际删除表
         // 磁盘中删除对应项
         Disk::RemoveFile(Disk::GetFilePath(current_database_oid_, table_oid));
+        Disk::RemoveFile(Disk::GetFsmPath(current_database_oid_, table_oid));
+        buffer_pool_.CloseFile(current_database_oid_, table_oid);
+        Disk::RemoveFile(Disk::GetFilePath(current_database_oid_, GetToastOid(table_oid)));
+        Disk::RemoveFile(Disk::GetFsmPath(current_database_oid_, GetToastOid(table_oid)));
+        buffer_pool_.CloseFile(current_database_oid_, GetToastOid(table_oid));
         oid2table_.erase(table_oid);
 
         // Step 3. OidManager 删除对应项
@@ -290,7 +298,7 @@ namespace huadb {
         return GetTable(oid)->GetColumnList();
     }
 
-    bool SystemCatalog::TableExists(oid_t oid) const { return oid_manager_.OidExists(oid); }
+    bool SystemCatalog::TableExists(oid_t oid) const { return oid_manager_.OidExists(GetToastOwnerOid(oid)); }
 
     oid_t SystemCatalog::GetNextOid() const { return oid_manager_.GetNextOid(); }
 
@@ -364,6 +372,12 @@ namespace huadb {
         }
     }
 
+    void SystemCatalog::SaveFreeSpaceMaps() {
+        for (const auto &[oid, table]: oid2table_) {
+            table->SaveFreeSpaceMap();
+        }
+    }
+
     void SystemCatalog::ExitDatabase() {
         // 约束检测
         assert(current_database_oid_ != INVALID_OID);
@@ -372,6 +386,7 @@ namespace huadb {
             return;
         }
         buffer_pool_.Flush(true);
+        SaveFreeSpaceMaps();
         // 直接利用 OidManager 信息进行删除
         std::vector<oid_t> deleted_oids{};
         for (const auto &[oid, _]: oid2table_) {
@@ -0,0 +1,144 @@
+#include "common/compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr size_t HASH_BITS = 12;
+
+static uint32_t Read32(const char *data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static size_t Hash(uint32_t value) { return (value * 2654435761U) >> (32 - HASH_BITS); }
+
+static void WriteLength(std::string &out, size_t length) {
+  for (; length >= 255; length -= 255) {
+    out.push_back(static_cast<char>(255));
+  }
+  out.push_back(static_cast<char>(length));
+}
+
+static void WriteSequence(std::string &out, std::string_view literals, size_t offset, size_t match_length) {
+  size_t literal_length = literals.size();
+  size_t match_code = match_length == 0 ? 0 : match_length - MIN_MATCH;
+  auto token = static_cast<uint8_t>((std::min<size_t>(literal_length, 15) << 4) | std::min<size_t>(match_code, 15));
+  out.push_back(static_cast<char>(token));
+  if (literal_length >= 15) {
+    WriteLength(out, literal_length - 15);
+  }
+  out.append(literals);
+  if (match_length == 0) {
+    return;
+  }
+  out.push_back(static_cast<char>(offset & 0xFF));
+  out.push_back(static_cast<char>(offset >> 8));
+  if (match_code >= 15) {
+    WriteLength(out, match_code - 15);
+  }
+}
+
+std::string Compression::Compress(std::string_view data) {
+  std::string out;
+  out.reserve(data.size());
+  std::vector<int64_t> table(1 << HASH_BITS, -1);
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + MIN_MATCH <= data.size()) {
+    auto value = Read32(data.data() + pos);
+    auto &candidate = table[Hash(value)];
+    auto previous = candidate;
+    candidate = static_cast<int64_t>(pos);
+    if (previous < 0) {
+      pos++;
+      continue;
+    }
+    auto match = static_cast<size_t>(previous);
+    if (pos - match > MAX_OFFSET || Read32(data.data() + match) != value) {
+      pos++;
+      continue;
+    }
+    size_t length = MIN_MATCH;
+    while (pos + length < data.size() && data[match + length] == data[pos + length]) {
+      length++;
+    }
+    WriteSequence(out, data.substr(anchor, pos - anchor), pos - match, length);
+    pos += length;
+    anchor = pos;
+    // 结果已不比原数据短时放弃压缩
+    if (out.size() >= data.size()) {
+      return "";
+    }
+  }
+  // 最后一个序列只有字面量
+  WriteSequence(out, data.substr(anchor), 0, 0);
+  if (out.size() >= data.size()) {
+    return "";
+  }
+  return out;
+}
+
+std::string Compression::Decompress(std::string_view data, size_t raw_size) {
+  std::string out;
+  out.reserve(raw_size);
+  size_t pos = 0;
+  auto read_length = [&](size_t length) {
+    uint8_t byte = 255;
+    while (byte == 255) {
+      if (pos >= data.size()) {
+        throw DbException("Corrupted compressed data");
+      }
+      byte = static_cast<uint8_t>(data[pos++]);
+      length += byte;
+    }
+    return length;
+  };
+  while (pos < data.size()) {
+    auto token = static_cast<uint8_t>(data[pos++]);
+    size_t literal_length = token >> 4;
+    if (literal_length == 15) {
+      literal_length = read_length(literal_length);
+    }
+    if (pos + literal_length > data.size() || out.size() + literal_length > raw_size) {
+      throw DbException("Corrupted compressed data");
+    }
+    out.append(data.substr(pos, literal_length));
+    pos += literal_length;
+    if (pos == data.size()) {
+      break;
+    }
+    if (pos + 2 > data.size()) {
+      throw DbException("Corrupted compressed data");
+    }
+    size_t offset = static_cast<uint8_t>(data[pos]) | (static_cast<size_t>(static_cast<uint8_t>(data[pos + 1])) << 8);
+    pos += 2;
+    size_t match_length = token & 0x0F;
+    if (match_length == 15) {
+      match_length = read_length(match_length);
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > out.size() || out.size() + match_length > raw_size) {
+      throw DbException("Corrupted compressed data");
+    }
+    // 匹配可能与自身重叠，逐字节复制
+    size_t start = out.size() - offset;
+    for (size_t i = 0; i < match_length; i++) {
+      out.push_back(out[start + i]);
+    }
+  }
+  if (out.size() != raw_size) {
+    throw DbException("Corrupted compressed data");
+  }
+  return out;
+}
+
+}  // namespace huadb
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace huadb {
+
+// LZ4 风格的字节级压缩：序列由标记字节（高 4 位为字面量长度，低 4 位为匹配长度减 4）、字面量、
+// 2 字节匹配偏移组成，长度不小于 15 时后接若干扩展字节。只用于 TOAST 中的大字段，不追求与 LZ4 格式兼容
+class Compression {
+ public:
+  // 压缩 data，结果不比原数据短时返回空串，调用者应保存原数据
+  static std::string Compress(std::string_view data);
+
+  // 解压缩为 raw_size 字节，数据损坏时抛出异常
+  static std::string Decompress(std::string_view data, size_t raw_size);
+};
+
+}  // namespace huadb
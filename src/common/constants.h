@@ -24,13 +24,54 @@ static constexpr const char *NEXT_LSN_NAME = "next_lsn";
 static constexpr const char *MASTER_RECORD_NAME = "master_record";
 
 static constexpr size_t LOG_SEGMENT_SIZE = (1 << 20);
-static constexpr size_t DB_PAGE_SIZE = (1 << 8);
-static constexpr size_t MAX_RECORD_SIZE = 230;
+// 页面大小在数据库创建时确定并写入控制文件，默认值为实验使用的 256 字节
+// 可选 4/8/16 KiB；页内偏移使用 db_size_t（16 位）存储，因此最大为 16 KiB
+static constexpr size_t DEFAULT_PAGE_SIZE = (1 << 8);
+static constexpr size_t MAX_PAGE_SIZE = (1 << 14);
+// 页头、槽位等保留空间，记录最大长度为页面大小减去该值
+static constexpr size_t PAGE_RESERVED_SIZE = 26;
+// 缓存池默认页面数，可通过 SET buffer_pool_size 修改
+static constexpr size_t DEFAULT_BUFFER_SIZE = 5;
+// 系统表缓存默认页面数，可通过 SET systable_buffer_pool_size 修改
+static constexpr size_t DEFAULT_SYSTABLE_BUFFER_SIZE = 128;
+// 后台写进程默认的执行间隔（毫秒）及每轮检查的页面数，可通过 SET bgwriter_delay、bgwriter_lru_maxpages 修改
+static constexpr size_t DEFAULT_BGWRITER_DELAY = 200;
+static constexpr size_t DEFAULT_BGWRITER_LRU_MAXPAGES = 100;
+// 自动清理进程默认的检查间隔（毫秒），可通过 SET autovacuum_naptime 修改
+static constexpr size_t DEFAULT_AUTOVACUUM_NAPTIME = 1000;
+// 表中已删除记录数超过 threshold + scale_factor * 表的记录数时自动清理，可通过 SET 修改
+static constexpr size_t DEFAULT_AUTOVACUUM_VACUUM_THRESHOLD = 50;
+static constexpr double DEFAULT_AUTOVACUUM_VACUUM_SCALE_FACTOR = 0.2;
+// 磁盘模块缓存的表文件描述符上限
+static constexpr size_t MAX_OPEN_FILES = 256;
+// 批量读写的默认并发度（线程池线程数、io_uring 队列深度），可通过 SET io_depth 修改
+static constexpr size_t DEFAULT_IO_DEPTH = 32;
+static constexpr size_t MAX_IO_DEPTH = 1024;
+// 顺序扫描默认预读的页面数，可通过 SET read_ahead_pages 修改，为 0 时不预读
+static constexpr size_t DEFAULT_READ_AHEAD_PAGES = 16;
+// 表文件每次预分配磁盘空间的页面数，可通过 SET extent_pages 修改，为 1 时不预分配
+static constexpr size_t DEFAULT_EXTENT_PAGES = 16;
+// 大表扫描的环形缓冲区默认大小，可通过 SET scan_ring_size 修改，为 0 时不使用
+// 默认关闭，保持实验中按缓存替换策略统计的磁盘访问次数不变
+static constexpr size_t DEFAULT_SCAN_RING_SIZE = 0;
+// 哈希连接等算子可使用的内存上限（KB），超过时将数据分区写入临时文件，可通过 SET work_mem 修改
+static constexpr size_t DEFAULT_WORK_MEM = 4096;
+// 批量插入时一次交给表的最大记录数，记录按页面批量写入并合并日志
+static constexpr size_t INSERT_BATCH_SIZE = 1024;
+
+static constexpr bool IsValidPageSize(size_t page_size) {
+  return page_size == DEFAULT_PAGE_SIZE || page_size == (1 << 12) || page_size == (1 << 13) ||
+         page_size == MAX_PAGE_SIZE;
+}
+
+// 记录最长长度
+static constexpr size_t GetMaxRecordSize(size_t page_size) { return page_size - PAGE_RESERVED_SIZE; }
+
 // 日志记录最长长度
-static constexpr size_t MAX_LOG_SIZE = sizeof(enum_t) + sizeof(xid_t) + sizeof(lsn_t) + sizeof(oid_t) + sizeof(oid_t) +
-                                       sizeof(pageid_t) + sizeof(slotid_t) + sizeof(db_size_t) + sizeof(db_size_t) +
-                                       MAX_RECORD_SIZE + sizeof(lsn_t);
-static constexpr size_t BUFFER_SIZE = 5;
+static constexpr size_t GetMaxLogSize(size_t page_size) {
+  return sizeof(enum_t) + sizeof(xid_t) + sizeof(lsn_t) + sizeof(oid_t) + sizeof(oid_t) + sizeof(pageid_t) +
+         sizeof(slotid_t) + sizeof(db_size_t) + sizeof(db_size_t) + GetMaxRecordSize(page_size) + sizeof(lsn_t);
+}
 
 static constexpr lsn_t FIRST_LSN = 0;
 static constexpr lsn_t NULL_LSN = -1;
@@ -47,6 +88,14 @@ static constexpr pageid_t NULL_PAGE_ID = 0xFFFFFFFF;
 // Catalog 相关
 static constexpr oid_t INVALID_OID = -1;
 static constexpr oid_t PRESERVED_OID = 10000;
+// 表中过长的字段存放在表的 TOAST 关系中，其 oid 为表的 oid 置最高位，文件与表位于同一数据库目录
+static constexpr oid_t TOAST_OID_FLAG = 0x80000000;
+static constexpr bool IsToastOid(oid_t oid) { return oid != INVALID_OID && (oid & TOAST_OID_FLAG) != 0; }
+static constexpr oid_t GetToastOid(oid_t table_oid) { return table_oid | TOAST_OID_FLAG; }
+// TOAST 关系所属表的 oid，其他 oid 原样返回
+static constexpr oid_t GetToastOwnerOid(oid_t oid) { return IsToastOid(oid) ? oid & ~TOAST_OID_FLAG : oid; }
+// 记录中变长字段的长度最高位为 1 时，字段存放在 TOAST 关系中，记录中只保存 TOAST 指针
+static constexpr db_size_t TOAST_LENGTH_FLAG = 0x8000;
 
 static constexpr oid_t SYSTEM_DATABASE_OID = 1;
 static constexpr oid_t TEMP_DATABASE_OID = 2;
@@ -1,10 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace huadb {
 
-enum class Type { BOOL, INT, UINT, DOUBLE, CHAR, VARCHAR, NULL_TYPE, LIST };
+enum class Type : uint8_t { BOOL, INT, UINT, DOUBLE, CHAR, VARCHAR, NULL_TYPE, LIST };
 
 class TypeUtil {
  public:
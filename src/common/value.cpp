@@ -1,5 +1,6 @@
 #include "common/value.h"
 
+#include <atomic>
 #include <cstring>
 #include <sstream>
 
@@ -7,9 +8,60 @@
 
 namespace huadb {
 
-    Value::Value() : is_null_(true), type_(Type::NULL_TYPE), size_(0) {}
+    struct Value::Block {
+        std::atomic<uint32_t> ref_count_{1};
+    };
+
+    struct Value::ListBlock : Value::Block {
+        explicit ListBlock(std::vector<Value> values) : values_(std::move(values)) {}
+
+        std::vector<Value> values_;
+    };
 
-    Value::Value(Type type, db_size_t size) : type_(type), size_(size), is_null_(true) {}
+    Value::Value() : type_(Type::NULL_TYPE), is_null_(true), size_(0) {}
+
+    Value::Value(const Value &other) : type_(other.type_), is_null_(other.is_null_), size_(other.size_),
+                                       val_(other.val_) {
+        Retain();
+    }
+
+    Value::Value(Value &&other) noexcept: type_(other.type_), is_null_(other.is_null_), size_(other.size_),
+                                          val_(other.val_) {
+        // 转移内存块的所有权，other 置为空值
+        other.type_ = Type::NULL_TYPE;
+        other.is_null_ = true;
+        other.size_ = 0;
+    }
+
+    Value &Value::operator=(const Value &other) {
+        if (this != &other) {
+            other.Retain();
+            Release();
+            type_ = other.type_;
+            is_null_ = other.is_null_;
+            size_ = other.size_;
+            val_ = other.val_;
+        }
+        return *this;
+    }
+
+    Value &Value::operator=(Value &&other) noexcept {
+        if (this != &other) {
+            Release();
+            type_ = other.type_;
+            is_null_ = other.is_null_;
+            size_ = other.size_;
+            val_ = other.val_;
+            other.type_ = Type::NULL_TYPE;
+            other.is_null_ = true;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    Value::~Value() { Release(); }
+
+    Value::Value(Type type, db_size_t size) : type_(type), is_null_(true), size_(size) {}
 
     Value::Value(bool val) : type_(Type::BOOL), size_(TypeUtil::TypeSize(Type::BOOL)) { val_.bool_ = val; }
 
@@ -17,19 +69,86 @@ namespace huadb {
 
     Value::Value(uint32_t val) : type_(Type::UINT), size_(TypeUtil::TypeSize(Type::UINT)) { val_.uint_ = val; }
 
-    Value::Value(double val) : type_(Type::DOUBLE), size_(TypeUtil::TypeSize(Type::DOUBLE)) { val_.double_ = val; }
+    Value::Value(double val) : type_(Type::DOUBLE), size_(TypeUtil::TypeSize(Type::DOUBLE)) { SetDouble(val); }
+
+    Value::Value(const char *val, Type type) : type_(type) { SetString(val, strlen(val)); }
+
+    Value::Value(const std::string &val, Type type) : type_(type) { SetString(val.data(), val.size()); }
+
+    Value::Value(std::string_view val, Type type) : type_(type) { SetString(val.data(), val.size()); }
 
-    Value::Value(const char *val, Type type) : type_(type) {
-        str_ = val;
-        size_ = str_.size();
+    Value::Value(std::vector<Value> values) : type_(Type::LIST), size_(0) {
+        SetBlock(new ListBlock(std::move(values)));
     }
 
-    Value::Value(std::string val, Type type) : type_(type) {
-        str_ = std::move(val);
-        size_ = str_.size();
+    bool Value::OwnsBlock() const {
+        if (is_null_) {
+            return false;
+        }
+        return type_ == Type::LIST || (TypeUtil::IsString(type_) && size_ > INLINE_STRING_SIZE);
+    }
+
+    Value::Block *Value::GetBlock() const {
+        Block *block;
+        memcpy(&block, val_.bytes_, sizeof(block));
+        return block;
     }
 
-    Value::Value(std::vector<Value> values) : values_(std::move(values)), type_(Type::LIST) {}
+    void Value::SetBlock(Block *block) { memcpy(val_.bytes_, &block, sizeof(block)); }
+
+    void Value::Retain() const {
+        if (OwnsBlock()) {
+            GetBlock()->ref_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Value::Release() {
+        if (!OwnsBlock()) {
+            return;
+        }
+        auto *block = GetBlock();
+        if (block->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (type_ == Type::LIST) {
+                delete static_cast<ListBlock *>(block);
+            } else {
+                block->~Block();
+                ::operator delete(block);
+            }
+        }
+    }
+
+    void Value::SetString(const char *data, db_size_t size) {
+        size_ = size;
+        if (size <= INLINE_STRING_SIZE) {
+            memcpy(val_.bytes_, data, size);
+            val_.bytes_[size] = '\0';
+            return;
+        }
+        // 长字符串存放在块头之后，保留结尾的 '\0'
+        void *memory = ::operator new(sizeof(Block) + size + 1);
+        auto *block = new(memory) Block();
+        char *chars = reinterpret_cast<char *>(block + 1);
+        memcpy(chars, data, size);
+        chars[size] = '\0';
+        SetBlock(block);
+    }
+
+    const char *Value::StringData() const {
+        if (size_ <= INLINE_STRING_SIZE) {
+            return val_.bytes_;
+        }
+        return reinterpret_cast<const char *>(GetBlock() + 1);
+    }
+
+    std::string_view Value::StringView() const { return {StringData(), size_}; }
+
+    double Value::GetDouble() const {
+        double val;
+        memcpy(&val, val_.bytes_, sizeof(val));
+        return val;
+    }
+
+    void Value::SetDouble(double val) { memcpy(val_.bytes_, &val, sizeof(val)); }
 
     bool Value::IsNull() const { return is_null_ || type_ == Type::NULL_TYPE; }
 
@@ -52,12 +171,12 @@ namespace huadb {
                 return std::to_string(val_.uint_);
             case Type::DOUBLE: {
                 std::ostringstream oss;
-                oss << val_.double_;
+                oss << GetDouble();
                 return oss.str();
             }
             case Type::CHAR:
             case Type::VARCHAR:
-                return str_;
+                return std::string(StringView());
             default:
                 throw DbException("Unknown value type in ToString");
         }
@@ -76,13 +195,13 @@ namespace huadb {
                 memcpy(data, &val_.uint_, size_);
                 break;
             case Type::DOUBLE:
-                memcpy(data, &val_.double_, size_);
+                memcpy(data, val_.bytes_, size_);
                 break;
             case Type::VARCHAR:
             case Type::CHAR: {
-                db_size_t str_size = str_.size();
+                db_size_t str_size = size_;
                 memcpy(data, &str_size, 2);
-                memcpy(data + 2, str_.c_str(), size_);
+                memcpy(data + 2, StringData(), size_);
                 result = str_size + 2;
                 break;
             }
@@ -93,6 +212,7 @@ namespace huadb {
     }
 
     db_size_t Value::DeserializeFrom(const char *data) {
+        Release();
         is_null_ = false;
         auto result = size_;
         switch (type_) {
@@ -106,12 +226,13 @@ namespace huadb {
                 memcpy(&val_.uint_, data, size_);
                 break;
             case Type::DOUBLE:
-                memcpy(&val_.double_, data, size_);
+                memcpy(val_.bytes_, data, size_);
                 break;
             case Type::VARCHAR:
             case Type::CHAR: {
-                memcpy(&size_, data, 2);
-                str_ = std::string(data + 2, data + size_ + 2);
+                db_size_t str_size;
+                memcpy(&str_size, data, 2);
+                SetString(data + 2, str_size);
                 result = size_ + 2;
                 break;
             }
@@ -123,7 +244,13 @@ namespace huadb {
 
     Type Value::GetType() const { return type_; }
 
-    const std::vector<Value> &Value::GetValues() const { return values_; }
+    const std::vector<Value> &Value::GetValues() const {
+        static const std::vector<Value> empty_values;
+        if (type_ != Type::LIST) {
+            return empty_values;
+        }
+        return static_cast<ListBlock *>(GetBlock())->values_;
+    }
 
     template<>
     bool Value::GetValue<bool>() const {
@@ -154,7 +281,7 @@ namespace huadb {
         if (type_ != Type::DOUBLE) {
             throw DbException("Type mismatch (expected double)");
         }
-        return val_.double_;
+        return GetDouble();
     }
 
     template<>
@@ -162,7 +289,15 @@ namespace huadb {
         if (!TypeUtil::IsString(type_)) {
             throw DbException("Type mismatch (expected char/varchar)");
         }
-        return str_;
+        return std::string(StringView());
+    }
+
+    template<>
+    std::string_view Value::GetValue<std::string_view>() const {
+        if (!TypeUtil::IsString(type_)) {
+            throw DbException("Type mismatch (expected char/varchar)");
+        }
+        return StringView();
     }
 
     template<>
@@ -170,7 +305,7 @@ namespace huadb {
         if (!TypeUtil::IsString(type_)) {
             throw DbException("Type mismatch (expected char/varchar)");
         }
-        return str_.c_str();
+        return StringData();
     }
 
     bool Value::Less(const Value &other) const {
@@ -181,10 +316,10 @@ namespace huadb {
             case Type::INT:
                 return val_.int_ < other.val_.int_;
             case Type::DOUBLE:
-                return val_.double_ < other.val_.double_;
+                return GetDouble() < other.GetDouble();
             case Type::CHAR:
             case Type::VARCHAR:
-                return str_ < other.str_;
+                return StringView() < other.StringView();
             default:
                 throw DbException("Type unsupported for Less operation");
         }
@@ -200,10 +335,10 @@ namespace huadb {
             case Type::INT:
                 return val_.int_ == other.val_.int_;
             case Type::DOUBLE:
-                return val_.double_ == other.val_.double_;
+                return GetDouble() == other.GetDouble();
             case Type::CHAR:
             case Type::VARCHAR:
-                return str_ == other.str_;
+                return StringView() == other.StringView();
             default:
                 throw DbException("Type unsupported for Equal operation");
         }
@@ -217,10 +352,10 @@ namespace huadb {
             case Type::INT:
                 return val_.int_ > other.val_.int_;
             case Type::DOUBLE:
-                return val_.double_ > other.val_.double_;
+                return GetDouble() > other.GetDouble();
             case Type::CHAR:
             case Type::VARCHAR:
-                return str_ > other.str_;
+                return StringView() > other.StringView();
             default:
                 throw DbException("Type unsupported for Greater operation");
         }
@@ -234,7 +369,7 @@ namespace huadb {
             case Type::INT:
                 return Value(val_.int_ + other.val_.int_);
             case Type::DOUBLE:
-                return Value(val_.double_ + other.val_.double_);
+                return Value(GetDouble() + other.GetDouble());
             default:
                 throw DbException("Type unsupported for Add operation");
         }
@@ -248,7 +383,7 @@ namespace huadb {
             case Type::INT:
                 return Value(std::max(val_.int_, other.val_.int_));
             case Type::DOUBLE:
-                return Value(std::max(val_.double_, other.val_.double_));
+                return Value(std::max(GetDouble(), other.GetDouble()));
             default:
                 throw DbException("Type unsupported for Max operation");
         }
@@ -262,7 +397,7 @@ namespace huadb {
             case Type::INT:
                 return Value(std::min(val_.int_, other.val_.int_));
             case Type::DOUBLE:
-                return Value(std::min(val_.double_, other.val_.double_));
+                return Value(std::min(GetDouble(), other.GetDouble()));
             default:
                 throw DbException("Type unsupported for Min operation");
         }
@@ -283,12 +418,13 @@ namespace huadb {
                 return Value(val_.bool_);
             case Type::CHAR:
             case Type::VARCHAR: {
-                if (str_ == "t") {
+                auto str = StringView();
+                if (str == "t") {
                     return Value(true);
-                } else if (str_ == "f") {
+                } else if (str == "f") {
                     return Value(false);
                 } else {
-                    throw DbException("Unknown str in CastAsBool: " + str_);
+                    throw DbException("Unknown str in CastAsBool: " + std::string(str));
                 }
             }
             default:
@@ -314,7 +450,7 @@ namespace std {
                 return std::hash<double>()(other.GetValue<double>());
             case huadb::Type::VARCHAR:
             case huadb::Type::CHAR:
-                return std::hash<std::string>()(other.GetValue<std::string>());
+                return std::hash<std::string_view>()(other.GetValue<std::string_view>());
             default:
                 throw huadb::DbException("Unknown value type in hash");
         }
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "common/type_util.h"
@@ -9,10 +10,23 @@
 
 namespace huadb {
 
+    // 紧凑的值表示，占 16 字节：类型、空值标记、长度与 12 字节的负载
+    // 数值类型直接存放在负载中；不超过 INLINE_STRING_SIZE 的字符串内联存放，更长的字符串和列表存放在带引用计数的
+    // 堆内存块中，复制值时只增加引用计数，不复制内容
     class Value {
     public:
         Value();
 
+        Value(const Value &other);
+
+        Value(Value &&other) noexcept;
+
+        Value &operator=(const Value &other);
+
+        Value &operator=(Value &&other) noexcept;
+
+        ~Value();
+
         Value(Type type, db_size_t size);
 
         explicit Value(bool val);
@@ -25,7 +39,9 @@ namespace huadb {
 
         explicit Value(const char *val, Type type = Type::VARCHAR);
 
-        explicit Value(std::string val, Type type = Type::VARCHAR);
+        explicit Value(const std::string &val, Type type = Type::VARCHAR);
+
+        explicit Value(std::string_view val, Type type = Type::VARCHAR);
 
         explicit Value(std::vector<Value> values);
 
@@ -65,20 +81,48 @@ namespace huadb {
         bool operator==(const Value &other) const;
 
     private:
+        // 内联字符串的最大长度，负载中保留一个字节存放结尾的 '\0'
+        static constexpr db_size_t INLINE_STRING_SIZE = 11;
+
+        // 堆内存块，多个值共享，引用计数归零时释放。长字符串的内容紧跟在块头之后
+        struct Block;
+        struct ListBlock;
+
+        // 是否持有堆内存块（长字符串或列表）
+        bool OwnsBlock() const;
+
+        Block *GetBlock() const;
+
+        void SetBlock(Block *block);
+
+        void Retain() const;
+
+        void Release();
+
+        void SetString(const char *data, db_size_t size);
+
+        const char *StringData() const;
+
+        std::string_view StringView() const;
+
+        double GetDouble() const;
+
+        void SetDouble(double val);
+
         Type type_;
         bool is_null_ = false;
+        db_size_t size_;
+        // 负载按 4 字节对齐，double 和指针通过 memcpy 存取
         union {
             bool bool_;
             int32_t int_;
             uint32_t uint_;
-            uint64_t uint64_;
-            double double_;
+            char bytes_[12];
         } val_;
-        std::string str_;
-        std::vector<Value> values_;
-        db_size_t size_;
     };
 
+    static_assert(sizeof(Value) == 16, "Value should stay 16 bytes");
+
 }  // namespace huadb
 
 namespace std {
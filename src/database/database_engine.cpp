@@ -1,6 +1,8 @@
 #include "database/database_engine.h"
 
+#include <algorithm>
 #include <exception>
+#include <fstream>
 
 #include "binder/binder.h"
 #include "binder/statements/statements.h"
@@ -11,13 +13,14 @@
 #include "database/connection.h"
 #include "executors/executor_context.h"
 #include "executors/executor_factory.h"
+#include "fmt/format.h"
 #include "operators/expressions/column_value.h"
 #include "postgres_parser.hpp"
 #include "table/record.h"
 
 namespace huadb {
 
-DatabaseEngine::DatabaseEngine() {
+DatabaseEngine::DatabaseEngine(size_t page_size, size_t buffer_size) {
   // 数据库是否正常关闭
   bool normal_shutdown = true;
   disk_ = std::make_unique<Disk>();
@@ -30,18 +33,42 @@ DatabaseEngine::DatabaseEngine() {
     lsn_t lsn;
     // 下一个事务id，lsn，oid，以及是否正常关闭
     in >> xid >> lsn >> oid >> normal_shutdown;
-    std::ofstream out(CONTROL_NAME);
-    out.flush();
-    out << xid << " " << lsn << " " << oid << " " << false << std::endl;
+    // 页面大小与缓存池大小，旧版本控制文件中不存在时使用默认值
+    size_t stored_page_size, stored_buffer_size;
+    if (!(in >> stored_page_size >> stored_buffer_size)) {
+      stored_page_size = DEFAULT_PAGE_SIZE;
+      stored_buffer_size = DEFAULT_BUFFER_SIZE;
+    }
+    // 页面大小决定了已有数据文件的格式，只能在创建数据库时指定
+    if (page_size != 0 && page_size != stored_page_size) {
+      throw DbException("Database was created with page size " + std::to_string(stored_page_size) +
+                        ", cannot open it with page size " + std::to_string(page_size));
+    }
+    disk_->SetPageSize(stored_page_size);
+    buffer_size_ = buffer_size != 0 ? buffer_size : stored_buffer_size;
+    if (!(in >> systable_buffer_size_)) {
+      systable_buffer_size_ = DEFAULT_SYSTABLE_BUFFER_SIZE;
+    }
+    std::string io_method;
+    if (in >> io_method >> io_depth_) {
+      io_method_ = String2IOMethod(io_method);
+    } else {
+      io_depth_ = DEFAULT_IO_DEPTH;
+    }
+    if (io_method_ != IOMethod::SYNC) {
+      disk_->SetIOMethod(io_method_, io_depth_);
+    }
+    WriteControlFile(xid, lsn, oid, false);
     transaction_manager_ = std::make_unique<TransactionManager>(*lock_manager_, xid);
     log_manager_ = std::make_unique<LogManager>(*disk_, *transaction_manager_, lsn);
   } else {
-    std::ofstream out(CONTROL_NAME);
-    out << FIRST_XID << " " << FIRST_LSN << " " << PRESERVED_OID << " " << false;
+    disk_->SetPageSize(page_size != 0 ? page_size : DEFAULT_PAGE_SIZE);
+    buffer_size_ = buffer_size != 0 ? buffer_size : DEFAULT_BUFFER_SIZE;
+    WriteControlFile(FIRST_XID, FIRST_LSN, PRESERVED_OID, false);
     transaction_manager_ = std::make_unique<TransactionManager>(*lock_manager_, FIRST_XID);
     log_manager_ = std::make_unique<LogManager>(*disk_, *transaction_manager_, FIRST_LSN);
   }
-  buffer_pool_ = std::make_shared<BufferPool>(*disk_, *log_manager_);
+  buffer_pool_ = std::make_shared<BufferPool>(*disk_, *log_manager_, buffer_size_, systable_buffer_size_);
   log_manager_->SetBufferPool(buffer_pool_);
 
   catalog_ = std::make_unique<Catalog>(*buffer_pool_, *log_manager_, oid);
@@ -62,6 +89,8 @@ DatabaseEngine::DatabaseEngine() {
 }
 
 DatabaseEngine::~DatabaseEngine() {
+  StopAutovacuum();
+  buffer_pool_->StopBackgroundWriter();
   // 如果数据库不是崩溃状态，关闭数据库
   if (std::uncaught_exceptions() == 0 && !crashed_) {
     CloseDatabase();
@@ -121,6 +150,16 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, co
     statement_nodes.push_back(reinterpret_cast<duckdb_libpgquery::PGNode *>(node->data.ptr_value));
   }
 
+  // 与自动清理进程互斥，多个连接的语句之间不互斥。VACUUM 可能截断表文件，与所有语句互斥
+  std::shared_lock engine_lock(engine_latch_, std::defer_lock);
+  std::unique_lock vacuum_lock(engine_latch_, std::defer_lock);
+  if (std::any_of(statement_nodes.begin(), statement_nodes.end(),
+                  [](auto *node) { return node->type == duckdb_libpgquery::T_PGVacuumStmt; })) {
+    vacuum_lock.lock();
+  } else {
+    engine_lock.lock();
+  }
+
   // Binder 负责语义分析，如检查查询涉及的表是否存在，如存在则绑定表的元数据
   Binder binder(*catalog_);
   for (auto *stmt : statement_nodes) {
@@ -233,6 +272,9 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, co
           break;
         }
         case StatementType::VACUUM_STATEMENT: {
+          if (CheckInTransaction(connection)) {
+            throw DbException("VACUUM cannot run inside a transaction block");
+          }
           const auto &vacuum_statement = dynamic_cast<VacuumStatement &>(*statement);
           Vacuum(vacuum_statement, writer);
           break;
@@ -269,7 +311,7 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, co
             }
             auto executor_context = std::make_unique<ExecutorContext>(
                 *buffer_pool_, *catalog_, *transaction_manager_, *lock_manager_, xids_[&connection], isolation_level,
-                transaction_manager_->GetCidAndIncrement(xids_[&connection]), is_modification_sql);
+                transaction_manager_->GetCidAndIncrement(xids_[&connection]), is_modification_sql, work_mem_);
 
             // 根据查询上下文和查询计划，生成执行器
             auto executor = ExecutorFactory::CreateExecutor(*executor_context, plan);
@@ -311,6 +353,8 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, co
 }
 
 void DatabaseEngine::Crash() {
+  StopAutovacuum();
+  buffer_pool_->StopBackgroundWriter();
   buffer_pool_->Clear();
   log_manager_->Clear();
   crashed_ = true;
@@ -339,6 +383,24 @@ void DatabaseEngine::CreateDatabase(const std::string &db_name, bool exists_ok,
   WriteOneCell("CREATE DATABASE", writer);
 }
 
+void DatabaseEngine::ShowBackgroundWriterStats(ResultWriter &writer) const {
+  auto stats = buffer_pool_->GetBackgroundWriterStats();
+  writer.BeginTable();
+  writer.BeginHeader();
+  for (const auto &header : {"running", "rounds", "pages_written", "backend_pages_written", "pages_per_second"}) {
+    writer.WriteHeaderCell(header);
+  }
+  writer.EndHeader();
+  writer.BeginRow();
+  writer.WriteCell(stats.running_ ? "on" : "off");
+  writer.WriteCell(std::to_string(stats.rounds_));
+  writer.WriteCell(std::to_string(stats.pages_written_));
+  writer.WriteCell(std::to_string(stats.backend_pages_written_));
+  writer.WriteCell(fmt::format("{:.2f}", stats.pages_per_second_));
+  writer.EndRow();
+  writer.EndTable();
+}
+
 void DatabaseEngine::ShowDatabases(ResultWriter &writer) const {
   writer.BeginTable();
   writer.BeginHeader();
@@ -372,13 +434,21 @@ void DatabaseEngine::DropDatabase(const std::string &db_name, bool missing_ok, R
 }
 
 void DatabaseEngine::CloseDatabase() {
+  StopAutovacuum();
+  buffer_pool_->StopBackgroundWriter();
   buffer_pool_->Flush();
   log_manager_->Flush();
   log_manager_->Checkpoint();
+  catalog_->SaveFreeSpaceMaps();
+
+  WriteControlFile(transaction_manager_->GetNextXid(), log_manager_->GetNextLSN(), catalog_->GetNextOid(), true);
+}
 
-  std::ofstream control(CONTROL_NAME);
-  control << transaction_manager_->GetNextXid() << " " << log_manager_->GetNextLSN() << " " << catalog_->GetNextOid()
-          << " " << true;
+void DatabaseEngine::WriteControlFile(xid_t xid, lsn_t lsn, oid_t oid, bool normal_shutdown) const {
+  std::ofstream out(CONTROL_NAME);
+  out << xid << " " << lsn << " " << oid << " " << normal_shutdown << " " << disk_->GetPageSize() << " "
+      << buffer_size_ << " " << systable_buffer_size_ << " " << IOMethod2String(io_method_) << " " << io_depth_
+      << std::endl;
 }
 
 void DatabaseEngine::CreateTable(const std::string &table_name, const ColumnList &column_list, ResultWriter &writer) {
@@ -529,6 +599,69 @@ void DatabaseEngine::VariableSet(const Connection &connection, const VariableSet
     enable_projection_pushdown_ = String2Bool(stmt.value_);
   } else if (stmt.variable_ == "deadlock") {
     lock_manager_->SetDeadLockType(String2DeadlockType(stmt.value_));
+  } else if (stmt.variable_ == "buffer_pool_size") {
+    // 有页面被 pin 时修改失败，成功后再记录
+    auto buffer_size = String2Size(stmt.value_);
+    buffer_pool_->SetBufferSize(buffer_size);
+    buffer_size_ = buffer_size;
+  } else if (stmt.variable_ == "systable_buffer_pool_size") {
+    auto systable_buffer_size = String2Size(stmt.value_);
+    buffer_pool_->SetSysTableBufferSize(systable_buffer_size);
+    systable_buffer_size_ = systable_buffer_size;
+  } else if (stmt.variable_ == "buffer_strategy") {
+    buffer_pool_->SetBufferStrategy(String2BufferStrategy(stmt.value_));
+  } else if (stmt.variable_ == "bgwriter") {
+    if (String2Bool(stmt.value_)) {
+      buffer_pool_->StartBackgroundWriter(bgwriter_delay_, bgwriter_lru_maxpages_);
+    } else {
+      buffer_pool_->StopBackgroundWriter();
+    }
+  } else if (stmt.variable_ == "bgwriter_delay" || stmt.variable_ == "bgwriter_lru_maxpages") {
+    if (stmt.variable_ == "bgwriter_delay") {
+      bgwriter_delay_ = String2Size(stmt.value_);
+    } else {
+      bgwriter_lru_maxpages_ = String2Size(stmt.value_);
+    }
+    // 运行中的后台写进程按新参数重启
+    if (buffer_pool_->GetBackgroundWriterStats().running_) {
+      buffer_pool_->StartBackgroundWriter(bgwriter_delay_, bgwriter_lru_maxpages_);
+    }
+  } else if (stmt.variable_ == "autovacuum") {
+    if (String2Bool(stmt.value_)) {
+      StartAutovacuum();
+    } else {
+      StopAutovacuum();
+    }
+  } else if (stmt.variable_ == "autovacuum_naptime") {
+    autovacuum_naptime_ = String2Size(stmt.value_);
+    // 运行中的清理进程按新间隔重启
+    if (autovacuum_thread_.joinable()) {
+      StartAutovacuum();
+    }
+  } else if (stmt.variable_ == "autovacuum_vacuum_threshold") {
+    autovacuum_vacuum_threshold_ = String2Size(stmt.value_, true);
+  } else if (stmt.variable_ == "autovacuum_vacuum_scale_factor") {
+    autovacuum_vacuum_scale_factor_ = String2Double(stmt.value_);
+  } else if (stmt.variable_ == "read_ahead_pages") {
+    // 0 表示关闭预读
+    buffer_pool_->SetReadAheadPages(String2Size(stmt.value_, true));
+  } else if (stmt.variable_ == "scan_ring_size") {
+    // 0 表示大表扫描不使用环形缓冲区
+    buffer_pool_->SetScanRingSize(String2Size(stmt.value_, true));
+  } else if (stmt.variable_ == "io_method" || stmt.variable_ == "io_depth") {
+    auto io_method = stmt.variable_ == "io_method" ? String2IOMethod(stmt.value_) : io_method_;
+    auto io_depth = stmt.variable_ == "io_depth" ? String2Size(stmt.value_) : io_depth_;
+    disk_->SetIOMethod(io_method, io_depth);
+    io_method_ = io_method;
+    io_depth_ = io_depth;
+  } else if (stmt.variable_ == "extent_pages") {
+    disk_->SetExtentPages(String2Size(stmt.value_));
+  } else if (stmt.variable_ == "work_mem") {
+    work_mem_ = String2Size(stmt.value_);
+  } else if (stmt.variable_ == "page_size") {
+    if (String2Size(stmt.value_) != disk_->GetPageSize()) {
+      throw DbException("page_size can only be chosen when the database is created");
+    }
   }
   client_variables_[&connection][stmt.variable_] = stmt.value_;
   WriteOneCell("SET", writer);
@@ -543,10 +676,35 @@ void DatabaseEngine::VariableShow(const Connection &connection, const VariableSh
   } else if (stmt.variable_ == "databases") {
     ShowDatabases(writer);
     return;
+  } else if (stmt.variable_ == "bgwriter_stats") {
+    ShowBackgroundWriterStats(writer);
+    return;
+  } else if (stmt.variable_ == "autovacuum_stats") {
+    ShowAutovacuumStats(writer);
+    return;
   } else if (stmt.variable_ == "disk_access_count") {
     result = std::to_string(disk_->GetAccessCount());
   } else if (stmt.variable_ == "redo_count") {
     result = std::to_string(log_manager_->GetRedoCount());
+  } else if (stmt.variable_ == "page_size") {
+    result = std::to_string(disk_->GetPageSize());
+  } else if (stmt.variable_ == "buffer_pool_size") {
+    result = std::to_string(buffer_pool_->GetBufferSize());
+  } else if (stmt.variable_ == "io_method") {
+    // 内核不支持 io_uring 时显示实际使用的线程池
+    result = IOMethod2String(disk_->GetIOMethod());
+  } else if (stmt.variable_ == "io_depth") {
+    result = std::to_string(io_depth_);
+  } else if (stmt.variable_ == "read_ahead_pages") {
+    result = std::to_string(buffer_pool_->GetReadAheadPages());
+  } else if (stmt.variable_ == "scan_ring_size") {
+    result = std::to_string(buffer_pool_->GetScanRingSize());
+  } else if (stmt.variable_ == "extent_pages") {
+    result = std::to_string(disk_->GetExtentPages());
+  } else if (stmt.variable_ == "work_mem") {
+    result = std::to_string(work_mem_);
+  } else if (stmt.variable_ == "systable_buffer_pool_size") {
+    result = std::to_string(buffer_pool_->GetSysTableBufferSize());
   } else {
     if (client_variables_.find(&connection) == client_variables_.end() ||
         client_variables_.at(&connection).find(stmt.variable_) == client_variables_.at(&connection).end()) {
@@ -617,9 +775,85 @@ void DatabaseEngine::Analyze(const AnalyzeStatement &stmt, ResultWriter &writer)
 
 void DatabaseEngine::Vacuum(const VacuumStatement &stmt, ResultWriter &writer) {
   // LAB 1 ADVANCED BEGIN
+  std::vector<std::string> table_names;
+  if (stmt.table_ == nullptr) {
+    table_names = catalog_->GetTableNames();
+  } else {
+    table_names.push_back(stmt.table_->table_);
+  }
+  // 早于所有活跃事务及其快照中事务的删除事务均已提交，删除的记录对任何事务都不可见
+  auto oldest_xid = transaction_manager_->GetOldestXid();
+  for (const auto &table_name : table_names) {
+    VacuumTable(table_name, oldest_xid);
+  }
   WriteOneCell("Vacuum", writer);
 }
 
+void DatabaseEngine::VacuumTable(const std::string &table_name, xid_t oldest_xid) {
+  auto table = catalog_->GetTable(catalog_->GetTableOid(table_name));
+  catalog_->SetCardinality(table_name, table->Vacuum(oldest_xid));
+}
+
+void DatabaseEngine::StartAutovacuum() {
+  StopAutovacuum();
+  autovacuum_stop_ = false;
+  autovacuum_thread_ = std::thread(&DatabaseEngine::AutovacuumLoop, this);
+}
+
+void DatabaseEngine::StopAutovacuum() {
+  if (!autovacuum_thread_.joinable()) {
+    return;
+  }
+  {
+    std::unique_lock lock(autovacuum_mutex_);
+    autovacuum_stop_ = true;
+  }
+  autovacuum_cv_.notify_all();
+  autovacuum_thread_.join();
+}
+
+void DatabaseEngine::AutovacuumLoop() {
+  std::unique_lock lock(autovacuum_mutex_);
+  while (!autovacuum_cv_.wait_for(lock, std::chrono::milliseconds(autovacuum_naptime_),
+                                  [this] { return autovacuum_stop_; })) {
+    // 停止清理进程的 SET 语句持有共享锁并等待本线程退出，因此等待独占锁至多一个检查间隔
+    std::unique_lock engine_lock(engine_latch_, std::chrono::milliseconds(autovacuum_naptime_));
+    if (!engine_lock.owns_lock()) {
+      autovacuum_skipped_++;
+      continue;
+    }
+    autovacuum_rounds_++;
+    auto oldest_xid = transaction_manager_->GetOldestXid();
+    for (const auto &table_name : catalog_->GetTableNames()) {
+      auto table = catalog_->GetTable(catalog_->GetTableOid(table_name));
+      // 未统计过基数的表只按固定阈值判断
+      auto cardinality = catalog_->GetCardinality(table_name);
+      auto threshold = autovacuum_vacuum_threshold_ +
+                       autovacuum_vacuum_scale_factor_ * (cardinality == INVALID_CARDINALITY ? 0 : cardinality);
+      if (table->GetDeadTupleCount() > threshold) {
+        VacuumTable(table_name, oldest_xid);
+        autovacuum_tables_++;
+      }
+    }
+  }
+}
+
+void DatabaseEngine::ShowAutovacuumStats(ResultWriter &writer) const {
+  writer.BeginTable();
+  writer.BeginHeader();
+  for (const auto &header : {"running", "rounds", "skipped_rounds", "tables_vacuumed"}) {
+    writer.WriteHeaderCell(header);
+  }
+  writer.EndHeader();
+  writer.BeginRow();
+  writer.WriteCell(autovacuum_thread_.joinable() ? "on" : "off");
+  writer.WriteCell(std::to_string(autovacuum_rounds_));
+  writer.WriteCell(std::to_string(autovacuum_skipped_));
+  writer.WriteCell(std::to_string(autovacuum_tables_));
+  writer.EndRow();
+  writer.EndTable();
+}
+
 void DatabaseEngine::WriteOneCell(const std::string &str, ResultWriter &writer) const {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -676,6 +910,45 @@ DeadlockType DatabaseEngine::String2DeadlockType(const std::string &str) {
   }
 }
 
+BufferStrategyType DatabaseEngine::String2BufferStrategy(const std::string &str) {
+  if (str == "lru") {
+    return BufferStrategyType::LRU;
+  } else if (str == "clock") {
+    return BufferStrategyType::CLOCK;
+  } else if (str == "lru_k") {
+    return BufferStrategyType::LRU_K;
+  } else if (str == "two_queue" || str == "2q") {
+    return BufferStrategyType::TWO_QUEUE;
+  } else {
+    throw DbException("Unknown buffer strategy " + str);
+  }
+}
+
+IOMethod DatabaseEngine::String2IOMethod(const std::string &str) {
+  if (str == "sync") {
+    return IOMethod::SYNC;
+  } else if (str == "thread_pool") {
+    return IOMethod::THREAD_POOL;
+  } else if (str == "io_uring") {
+    return IOMethod::IO_URING;
+  } else {
+    throw DbException("Unknown io method " + str);
+  }
+}
+
+std::string DatabaseEngine::IOMethod2String(IOMethod io_method) {
+  switch (io_method) {
+    case IOMethod::SYNC:
+      return "sync";
+    case IOMethod::THREAD_POOL:
+      return "thread_pool";
+    case IOMethod::IO_URING:
+      return "io_uring";
+    default:
+      throw DbException("Unknown io method");
+  }
+}
+
 bool DatabaseEngine::String2Bool(const std::string &str) {
   if (str == "true" || str == "1" || str == "on") {
     return true;
@@ -685,4 +958,32 @@ bool DatabaseEngine::String2Bool(const std::string &str) {
   throw DbException("Unknown boolean value " + str);
 }
 
+size_t DatabaseEngine::String2Size(const std::string &str, bool allow_zero) {
+  size_t pos = 0;
+  unsigned long long size = 0;
+  try {
+    size = std::stoull(str, &pos);
+  } catch (std::exception &e) {
+    throw DbException("Unknown size value " + str);
+  }
+  if (pos != str.size() || (size == 0 && !allow_zero)) {
+    throw DbException("Unknown size value " + str);
+  }
+  return size;
+}
+
+double DatabaseEngine::String2Double(const std::string &str) {
+  size_t pos = 0;
+  double value = 0;
+  try {
+    value = std::stod(str, &pos);
+  } catch (std::exception &e) {
+    throw DbException("Unknown numeric value " + str);
+  }
+  if (pos != str.size() || value < 0) {
+    throw DbException("Unknown numeric value " + str);
+  }
+  return value;
+}
+
 }  // namespace huadb
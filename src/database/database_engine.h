@@ -1,7 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -29,7 +34,8 @@ class VacuumStatement;
 
 class DatabaseEngine {
  public:
-  DatabaseEngine();
+  // page_size、buffer_size 为 0 时使用控制文件中的值（不存在时使用默认值）
+  explicit DatabaseEngine(size_t page_size = 0, size_t buffer_size = 0);
   ~DatabaseEngine();
 
   const std::string &GetCurrentDatabase() const;
@@ -52,10 +58,12 @@ class DatabaseEngine {
   void ChangeDatabase(const std::string &db_name, ResultWriter &writer);
   void DropDatabase(const std::string &db_name, bool missing_ok, ResultWriter &writer);
   void CloseDatabase();
+  void WriteControlFile(xid_t xid, lsn_t lsn, oid_t oid, bool normal_shutdown) const;
 
   void CreateTable(const std::string &table_name, const ColumnList &column_list, ResultWriter &writer);
   void DescribeTable(const std::string &table_name, ResultWriter &writer) const;
   void ShowTables(ResultWriter &writer) const;
+  void ShowBackgroundWriterStats(ResultWriter &writer) const;
   void DropTable(const std::string &table_name, ResultWriter &writer);
 
   void CreateIndex(const std::string &index_name, const std::string &table_name,
@@ -76,6 +84,15 @@ class DatabaseEngine {
 
   void Analyze(const AnalyzeStatement &stmt, ResultWriter &writer);
   void Vacuum(const VacuumStatement &stmt, ResultWriter &writer);
+  // 回收表中对所有事务均不可见的记录，并以清理后的记录数更新表的基数
+  void VacuumTable(const std::string &table_name, xid_t oldest_xid);
+
+  // 自动清理进程按 autovacuum_naptime 的间隔检查各表，已删除记录数超过阈值时清理
+  // 清理时独占 engine_latch_，一个检查间隔内一直有语句在执行时跳过本轮
+  void StartAutovacuum();
+  void StopAutovacuum();
+  void AutovacuumLoop();
+  void ShowAutovacuumStats(ResultWriter &writer) const;
 
   void WriteOneCell(const std::string &str, ResultWriter &writer) const;
 
@@ -83,7 +100,12 @@ class DatabaseEngine {
   static ForceJoin String2ForceJoin(const std::string &str);
   static JoinOrderAlgorithm String2JoinOrderAlgorithm(const std::string &str);
   static DeadlockType String2DeadlockType(const std::string &str);
+  static BufferStrategyType String2BufferStrategy(const std::string &str);
+  static IOMethod String2IOMethod(const std::string &str);
+  static std::string IOMethod2String(IOMethod io_method);
   static bool String2Bool(const std::string &str);
+  static size_t String2Size(const std::string &str, bool allow_zero = false);
+  static double String2Double(const std::string &str);
 
   std::string current_db_;
 
@@ -103,6 +125,28 @@ class DatabaseEngine {
   JoinOrderAlgorithm join_order_algorithm_ = DEFAULT_JOIN_ORDER_ALGORITHM;
   bool enable_optimizer_ = true;
   bool enable_projection_pushdown_ = false;
+  size_t buffer_size_ = DEFAULT_BUFFER_SIZE;
+  size_t systable_buffer_size_ = DEFAULT_SYSTABLE_BUFFER_SIZE;
+  size_t work_mem_ = DEFAULT_WORK_MEM;  // KB
+  // 批量读写方式，记录在控制文件中，重启后的故障恢复也按此方式读取页面
+  IOMethod io_method_ = IOMethod::SYNC;
+  size_t io_depth_ = DEFAULT_IO_DEPTH;
+  size_t bgwriter_delay_ = DEFAULT_BGWRITER_DELAY;
+  size_t bgwriter_lru_maxpages_ = DEFAULT_BGWRITER_LRU_MAXPAGES;
+
+  size_t autovacuum_naptime_ = DEFAULT_AUTOVACUUM_NAPTIME;
+  size_t autovacuum_vacuum_threshold_ = DEFAULT_AUTOVACUUM_VACUUM_THRESHOLD;
+  double autovacuum_vacuum_scale_factor_ = DEFAULT_AUTOVACUUM_VACUUM_SCALE_FACTOR;
+
+  // 语句执行时持有共享锁，自动清理进程持有独占锁
+  std::shared_timed_mutex engine_latch_;
+  std::thread autovacuum_thread_;
+  std::mutex autovacuum_mutex_;
+  std::condition_variable autovacuum_cv_;
+  bool autovacuum_stop_ = false;
+  std::atomic<size_t> autovacuum_rounds_ = 0;     // 执行清理的轮数
+  std::atomic<size_t> autovacuum_skipped_ = 0;    // 因语句持续执行而跳过的轮数
+  std::atomic<size_t> autovacuum_tables_ = 0;     // 清理过的表数
 
   bool crashed_ = false;
 };
@@ -6,15 +6,369 @@ AggregateExecutor::AggregateExecutor(ExecutorContext &context, std::shared_ptr<c
                                      std::shared_ptr<Executor> child)
     : Executor(context, {std::move(child)}), plan_(std::move(plan)) {
   // LAB 4 ADVANCED BEGIN
+  key_count_ = plan_->GetGroupBys().size();
+  aggregate_count_ = plan_->GetAggregates().size();
+  for (bool is_distinct : plan_->is_distincts_) {
+    has_distinct_ = has_distinct_ || is_distinct;
+  }
+  direct_ = key_count_ == 1 && plan_->GetGroupBys()[0]->GetValueType() == Type::INT;
 }
 
 void AggregateExecutor::Init() {
+  children_[0]->Init();
   // LAB 4 ADVANCED BEGIN
+  jobs_.clear();
+  input_file_ = nullptr;
+  depth_ = 0;
+  Build();
 }
 
 std::shared_ptr<Record> AggregateExecutor::Next() {
   // LAB 4 ADVANCED BEGIN
-  return nullptr;
+  while (output_group_ >= group_count_) {
+    if (!NextJob()) {
+      return nullptr;
+    }
+  }
+  auto group = output_group_++;
+  std::vector<Value> values;
+  values.reserve(key_count_ + aggregate_count_);
+  auto keys = group_keys_.begin() + group * key_count_;
+  values.insert(values.end(), keys, keys + key_count_);
+  const auto &aggregate_types = plan_->GetAggregateTypes();
+  for (size_t i = 0; i < aggregate_count_; i++) {
+    values.push_back(Finalize(aggregate_types[i], states_[group * aggregate_count_ + i]));
+  }
+  return std::make_shared<Record>(std::move(values));
+}
+
+size_t AggregateExecutor::DistinctKeyHash::operator()(const DistinctKey &key) const {
+  return std::hash<Value>()(key.value_) ^ (key.group_ * 0x9E3779B97F4A7C15ULL);
+}
+
+bool AggregateExecutor::DistinctKeyEqual::operator()(const DistinctKey &lhs, const DistinctKey &rhs) const {
+  return lhs.group_ == rhs.group_ && lhs.value_.Equal(rhs.value_);
+}
+
+uint32_t AggregateExecutor::Hash(const std::vector<Value> &keys) {
+  uint64_t hash = 0;
+  for (const auto &key : keys) {
+    hash = hash * 31 + (key.IsNull() ? 0 : std::hash<Value>()(key));
+  }
+  // 整数的 std::hash 为恒等映射，乘法散列后取高位，使连续的键均匀分布在各槽位
+  return static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+bool AggregateExecutor::KeyEqual(const Value &lhs, const Value &rhs) {
+  if (lhs.IsNull() || rhs.IsNull()) {
+    return lhs.IsNull() && rhs.IsNull();
+  }
+  return lhs.Equal(rhs);
+}
+
+size_t AggregateExecutor::GetPartition(uint32_t hash) const {
+  // 每层使用不同的种子，与槽位使用的哈希值高位相互独立，上一层同一分区中的键在下一层可以再次分开
+  uint64_t mixed = hash ^ ((depth_ + 1) * 0xC2B2AE3D27D4EB4FULL);
+  mixed = (mixed ^ (mixed >> 33)) * 0xFF51AFD7ED558CCDULL;
+  mixed = (mixed ^ (mixed >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+  return (mixed ^ (mixed >> 33)) % SPILL_PARTITIONS;
+}
+
+void AggregateExecutor::Build() {
+  ResetTable();
+  partitions_.clear();
+  spilling_ = false;
+  if (key_count_ == 0) {
+    // 没有分组键时即使没有输入也输出一行。只有一个分组，无法分区
+    std::vector<Value> keys;
+    CreateGroup(keys, 0);
+  }
+  // 溢出分区中是部分聚合结果还是输入记录
+  bool partial = input_file_ != nullptr && !has_distinct_;
+  const auto &group_bys = plan_->GetGroupBys();
+  std::vector<Value> keys(key_count_);
+  while (auto record = NextInputRecord()) {
+    uint32_t group = 0;
+    if (key_count_ > 0) {
+      for (size_t i = 0; i < key_count_; i++) {
+        keys[i] = partial ? record->GetValue(i) : group_bys[i]->Evaluate(record);
+      }
+      auto hash = Hash(keys);
+      group = FindGroup(keys, hash);
+      if (group == NULL_GROUP) {
+        if (spilling_) {
+          partitions_[GetPartition(hash)]->Append(*record);
+          continue;
+        }
+        group = InsertGroup(keys, hash);
+      }
+    }
+    if (partial) {
+      Merge(group, *record);
+    } else {
+      Accumulate(group, record);
+    }
+    if (key_count_ > 0 && !spilling_ && depth_ < MAX_SPILL_DEPTH && OverMemoryLimit()) {
+      if (partitions_.empty()) {
+        for (size_t i = 0; i < SPILL_PARTITIONS; i++) {
+          partitions_.push_back(std::make_unique<TempFile>());
+        }
+      }
+      if (has_distinct_) {
+        spilling_ = true;
+      } else {
+        SpillGroups();
+      }
+    }
+  }
+  if (!has_distinct_ && !partitions_.empty()) {
+    // 内存中的分组可能已有部分结果写出，需要在分区中一起合并
+    SpillGroups();
+  }
+}
+
+bool AggregateExecutor::NextJob() {
+  for (auto &partition : partitions_) {
+    if (partition->GetRecordCount() > 0) {
+      jobs_.emplace_back(std::move(partition), depth_ + 1);
+    }
+  }
+  partitions_.clear();
+  if (jobs_.empty()) {
+    return false;
+  }
+  input_file_ = std::move(jobs_.back().first);
+  depth_ = jobs_.back().second;
+  jobs_.pop_back();
+  input_file_->Rewind();
+  Build();
+  return true;
+}
+
+std::shared_ptr<Record> AggregateExecutor::NextInputRecord() {
+  return input_file_ != nullptr ? input_file_->Next() : children_[0]->Next();
+}
+
+void AggregateExecutor::ResetTable() {
+  group_keys_.clear();
+  group_hashes_.clear();
+  states_.clear();
+  group_count_ = 0;
+  slots_.assign(16, {});
+  used_slots_ = 0;
+  if (direct_) {
+    direct_groups_.assign(DIRECT_GROUP_KEYS, NULL_GROUP);
+  }
+  distinct_values_.assign(aggregate_count_, {});
+  memory_usage_ = 0;
+  output_group_ = 0;
+}
+
+int32_t AggregateExecutor::DirectIndex(const std::vector<Value> &keys) const {
+  if (direct_ && !keys[0].IsNull() && keys[0].GetType() == Type::INT) {
+    auto key = keys[0].GetValue<int32_t>();
+    if (key >= 0 && key < DIRECT_GROUP_KEYS) {
+      return key;
+    }
+  }
+  return -1;
+}
+
+uint32_t AggregateExecutor::FindGroup(const std::vector<Value> &keys, uint32_t hash) const {
+  auto index = DirectIndex(keys);
+  if (index >= 0) {
+    return direct_groups_[index];
+  }
+  auto mask = slots_.size() - 1;
+  for (auto i = hash & mask;; i = (i + 1) & mask) {
+    const auto &slot = slots_[i];
+    if (slot.group_ == NULL_GROUP) {
+      return NULL_GROUP;
+    }
+    if (slot.hash_ != hash) {
+      continue;
+    }
+    auto group_keys = group_keys_.begin() + slot.group_ * key_count_;
+    bool equal = true;
+    for (size_t j = 0; j < key_count_ && equal; j++) {
+      equal = KeyEqual(group_keys[j], keys[j]);
+    }
+    if (equal) {
+      return slot.group_;
+    }
+  }
+}
+
+uint32_t AggregateExecutor::InsertGroup(std::vector<Value> &keys, uint32_t hash) {
+  auto index = DirectIndex(keys);
+  auto group = CreateGroup(keys, hash);
+  if (index >= 0) {
+    direct_groups_[index] = group;
+    return group;
+  }
+  auto mask = slots_.size() - 1;
+  auto i = hash & mask;
+  while (slots_[i].group_ != NULL_GROUP) {
+    i = (i + 1) & mask;
+  }
+  slots_[i] = {hash, group};
+  // 装载因子不超过 1/2，保持探测序列较短
+  if (++used_slots_ * 2 > slots_.size()) {
+    Grow();
+  }
+  return group;
+}
+
+uint32_t AggregateExecutor::CreateGroup(std::vector<Value> &keys, uint32_t hash) {
+  // 分组键、哈希值与聚合状态占用的内存，超出内联长度的字符串另计
+  memory_usage_ += sizeof(uint32_t) + aggregate_count_ * sizeof(AggregateState);
+  for (auto &key : keys) {
+    memory_usage_ += sizeof(Value) + (TypeUtil::IsString(key.GetType()) ? key.GetSize() : 0);
+    group_keys_.push_back(std::move(key));
+  }
+  group_hashes_.push_back(hash);
+  states_.resize(states_.size() + aggregate_count_);
+  return static_cast<uint32_t>(group_count_++);
+}
+
+void AggregateExecutor::Grow() {
+  std::vector<Slot> slots(slots_.size() * 2);
+  auto mask = slots.size() - 1;
+  for (const auto &slot : slots_) {
+    if (slot.group_ == NULL_GROUP) {
+      continue;
+    }
+    auto i = slot.hash_ & mask;
+    while (slots[i].group_ != NULL_GROUP) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+  }
+  slots_ = std::move(slots);
+}
+
+bool AggregateExecutor::OverMemoryLimit() const {
+  return memory_usage_ + slots_.size() * sizeof(Slot) > context_.GetWorkMem();
+}
+
+void AggregateExecutor::SpillGroups() {
+  for (size_t group = 0; group < group_count_; group++) {
+    std::vector<Value> values;
+    values.reserve(key_count_ + aggregate_count_ * 2);
+    auto keys = group_keys_.begin() + group * key_count_;
+    values.insert(values.end(), keys, keys + key_count_);
+    for (size_t i = 0; i < aggregate_count_; i++) {
+      const auto &state = states_[group * aggregate_count_ + i];
+      values.push_back(state.value_);
+      values.emplace_back(static_cast<double>(state.count_));
+    }
+    partitions_[GetPartition(group_hashes_[group])]->Append(Record(std::move(values)));
+  }
+  ResetTable();
+}
+
+void AggregateExecutor::Accumulate(uint32_t group, const std::shared_ptr<Record> &record) {
+  const auto &aggregates = plan_->GetAggregates();
+  const auto &aggregate_types = plan_->GetAggregateTypes();
+  auto *states = states_.data() + group * aggregate_count_;
+  for (size_t i = 0; i < aggregate_count_; i++) {
+    auto &state = states[i];
+    if (aggregate_types[i] == AggregateType::COUNT_STAR) {
+      state.count_++;
+      continue;
+    }
+    auto value = aggregates[i]->Evaluate(record);
+    if (value.IsNull()) {
+      continue;
+    }
+    if (plan_->is_distincts_[i]) {
+      if (!distinct_values_[i].insert({group, value}).second) {
+        continue;
+      }
+      memory_usage_ += sizeof(DistinctKey) + 2 * sizeof(void *) +
+                       (TypeUtil::IsString(value.GetType()) ? value.GetSize() : 0);
+    }
+    switch (aggregate_types[i]) {
+      case AggregateType::COUNT:
+        state.count_++;
+        break;
+      case AggregateType::SUM:
+        state.value_ = state.value_.IsNull() ? std::move(value) : state.value_.Add(value);
+        break;
+      case AggregateType::AVG: {
+        double val;
+        if (value.GetType() == Type::INT) {
+          val = value.GetValue<int32_t>();
+        } else if (value.GetType() == Type::DOUBLE) {
+          val = value.GetValue<double>();
+        } else {
+          throw DbException("Type unsupported for AVG aggregate");
+        }
+        state.value_ = Value((state.value_.IsNull() ? 0.0 : state.value_.GetValue<double>()) + val);
+        state.count_++;
+        break;
+      }
+      case AggregateType::MIN:
+        if (state.value_.IsNull() || value.Less(state.value_)) {
+          state.value_ = std::move(value);
+        }
+        break;
+      case AggregateType::MAX:
+        if (state.value_.IsNull() || value.Greater(state.value_)) {
+          state.value_ = std::move(value);
+        }
+        break;
+      default:
+        throw DbException("Unknown aggregate type");
+    }
+  }
+}
+
+void AggregateExecutor::Merge(uint32_t group, const Record &partial) {
+  const auto &aggregate_types = plan_->GetAggregateTypes();
+  const auto &values = partial.GetValues();
+  auto *states = states_.data() + group * aggregate_count_;
+  for (size_t i = 0; i < aggregate_count_; i++) {
+    auto &state = states[i];
+    const auto &value = values[key_count_ + i * 2];
+    state.count_ += static_cast<int64_t>(values[key_count_ + i * 2 + 1].GetValue<double>());
+    if (value.IsNull()) {
+      continue;
+    }
+    switch (aggregate_types[i]) {
+      case AggregateType::SUM:
+      case AggregateType::AVG:
+        state.value_ = state.value_.IsNull() ? value : state.value_.Add(value);
+        break;
+      case AggregateType::MIN:
+        if (state.value_.IsNull() || value.Less(state.value_)) {
+          state.value_ = value;
+        }
+        break;
+      case AggregateType::MAX:
+        if (state.value_.IsNull() || value.Greater(state.value_)) {
+          state.value_ = value;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+Value AggregateExecutor::Finalize(AggregateType type, const AggregateState &state) const {
+  switch (type) {
+    case AggregateType::COUNT_STAR:
+    case AggregateType::COUNT:
+      return Value(static_cast<int32_t>(state.count_));
+    case AggregateType::AVG:
+      if (state.count_ == 0) {
+        return Value();
+      }
+      return Value(state.value_.GetValue<double>() / state.count_);
+    default:
+      return state.value_;
+  }
 }
 
 }  // namespace huadb
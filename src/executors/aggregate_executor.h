@@ -1,10 +1,21 @@
 #pragma once
 
+#include <memory>
+#include <unordered_set>
+
 #include "executors/executor.h"
 #include "operators/aggregate_operator.h"
+#include "storage/temp_file.h"
 
 namespace huadb {
 
+// 哈希聚合：读入子节点的全部记录，按分组键归入各分组并更新聚合状态，之后逐个输出分组
+// 分组键与聚合状态分别按分组号平铺存放在连续数组中，每个聚合函数占一个固定布局的状态槽位。
+// 没有分组键时只有一个分组，不需要查找；单个整数分组键取值较小时直接以键为下标查找分组，其余情况使用
+// 开放定址（线性探测）的哈希表。与 PostgreSQL 一致，分组键为空的记录归入同一分组，聚合函数忽略空值
+// 分组占用的内存超过 work_mem 时按分组键的哈希值分区写入临时文件，输入读完后逐个分区读回聚合，单个分区仍然过大时
+// 以新的哈希种子递归分区。没有 DISTINCT 聚合函数时写出各分组的部分聚合结果并清空哈希表（预聚合），读回时合并状态；
+// 有 DISTINCT 聚合函数时部分结果无法合并，此时已有分组留在内存中继续聚合，只将新分组的输入记录写入临时文件
 class AggregateExecutor : public Executor {
  public:
   AggregateExecutor(ExecutorContext &context, std::shared_ptr<const AggregateOperator> plan,
@@ -13,7 +24,103 @@ class AggregateExecutor : public Executor {
   std::shared_ptr<Record> Next() override;
 
  private:
+  static constexpr uint32_t NULL_GROUP = UINT32_MAX;
+  // 直接下标查找的整数分组键范围 [0, DIRECT_GROUP_KEYS)
+  static constexpr int32_t DIRECT_GROUP_KEYS = 4096;
+  // 每次分区的分区数
+  static constexpr size_t SPILL_PARTITIONS = 16;
+  // 最大分区层数，达到后不再分区，直接在内存中聚合
+  static constexpr size_t MAX_SPILL_DEPTH = 3;
+
+  struct Slot {
+    uint32_t hash_;
+    uint32_t group_ = NULL_GROUP;  // 为 NULL_GROUP 时槽位为空
+  };
+
+  // 一个聚合函数在一个分组中的状态。SUM、MIN、MAX 的当前结果与 AVG 的和（DOUBLE）存放在 value_ 中，
+  // 尚无非空输入时 value_ 为空值；COUNT、COUNT(*) 与 AVG 的计数存放在 count_ 中
+  struct AggregateState {
+    Value value_;
+    int64_t count_ = 0;
+  };
+
+  // DISTINCT 聚合函数已见过的（分组号，参数值）
+  struct DistinctKey {
+    uint32_t group_;
+    Value value_;
+  };
+  struct DistinctKeyHash {
+    size_t operator()(const DistinctKey &key) const;
+  };
+  struct DistinctKeyEqual {
+    bool operator()(const DistinctKey &lhs, const DistinctKey &rhs) const;
+  };
+
+  static uint32_t Hash(const std::vector<Value> &keys);
+  // 分组键比较，两个空值视为相等
+  static bool KeyEqual(const Value &lhs, const Value &rhs);
+
+  // 分组键在第 depth_ 层分区中所属的分区
+  size_t GetPartition(uint32_t hash) const;
+
+  // 读入当前任务的全部输入并完成聚合，超过内存上限时分区
+  void Build();
+  // 开始下一个溢出分区的聚合，没有时返回 false
+  bool NextJob();
+  std::shared_ptr<Record> NextInputRecord();
+
+  // 清空全部分组
+  void ResetTable();
+  // 可直接下标查找时返回下标，否则返回 -1
+  int32_t DirectIndex(const std::vector<Value> &keys) const;
+  // 查找分组，不存在时返回 NULL_GROUP
+  uint32_t FindGroup(const std::vector<Value> &keys, uint32_t hash) const;
+  // 创建分组并加入查找结构
+  uint32_t InsertGroup(std::vector<Value> &keys, uint32_t hash);
+  uint32_t CreateGroup(std::vector<Value> &keys, uint32_t hash);
+  // 槽位数翻倍并按保存的哈希值重新插入
+  void Grow();
+
+  // 分组占用的内存是否超过 work_mem
+  bool OverMemoryLimit() const;
+  // 将全部分组的部分聚合结果写入分区并清空哈希表
+  void SpillGroups();
+
+  // 用一条输入记录更新分组的全部聚合状态
+  void Accumulate(uint32_t group, const std::shared_ptr<Record> &record);
+  // 将一条部分聚合结果合并到分组中。部分聚合结果依次为分组键与各聚合函数的 value_、count_，
+  // count_ 以 DOUBLE 存放（2^53 以内精确）
+  void Merge(uint32_t group, const Record &partial);
+  // 计算聚合函数的最终结果
+  Value Finalize(AggregateType type, const AggregateState &state) const;
+
   std::shared_ptr<const AggregateOperator> plan_;
+
+  size_t key_count_ = 0;        // 分组键个数
+  size_t aggregate_count_ = 0;  // 聚合函数个数
+  bool has_distinct_ = false;   // 是否有 DISTINCT 聚合函数
+
+  std::vector<Value> group_keys_;       // 分组 i 的分组键位于 [i * key_count_, (i + 1) * key_count_)
+  std::vector<uint32_t> group_hashes_;  // 各分组键的哈希值
+  std::vector<AggregateState> states_;  // 分组 i 的状态位于 [i * aggregate_count_, (i + 1) * aggregate_count_)
+  size_t group_count_ = 0;
+
+  std::vector<Slot> slots_;  // 槽位数为 2 的幂
+  size_t used_slots_ = 0;
+  bool direct_ = false;                  // 是否为单个整数分组键启用直接下标查找
+  std::vector<uint32_t> direct_groups_;  // 以分组键为下标的分组号
+
+  std::vector<std::unordered_set<DistinctKey, DistinctKeyHash, DistinctKeyEqual>> distinct_values_;
+  size_t memory_usage_ = 0;  // 分组占用的内存估计
+
+  // 当前任务的输入与分区
+  std::unique_ptr<TempFile> input_file_;  // 为空指针时读取子节点
+  size_t depth_ = 0;
+  std::vector<std::unique_ptr<TempFile>> partitions_;  // 未分区时为空
+  bool spilling_ = false;                             // 是否不再创建新分组（有 DISTINCT 聚合函数时）
+  std::vector<std::pair<std::unique_ptr<TempFile>, size_t>> jobs_;  // 待聚合的溢出分区与其层数
+
+  size_t output_group_ = 0;  // 下一个输出的分组
 };
 
 }  // namespace huadb
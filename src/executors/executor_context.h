@@ -10,7 +10,7 @@ namespace huadb {
     public:
         ExecutorContext(BufferPool &buffer_pool, Catalog &catalog, TransactionManager &transaction_manager,
                         LockManager &lock_manager, xid_t xid, IsolationLevel isolation_level, cid_t cid,
-                        bool is_modification_sql)
+                        bool is_modification_sql, size_t work_mem = DEFAULT_WORK_MEM)
                 : buffer_pool_(buffer_pool),
                   catalog_(catalog),
                   transaction_manager_(transaction_manager),
@@ -18,7 +18,8 @@ namespace huadb {
                   xid_(xid),
                   isolation_level_(isolation_level),
                   cid_(cid),
-                  is_modification_sql_(is_modification_sql) {}
+                  is_modification_sql_(is_modification_sql),
+                  work_mem_(work_mem) {}
 
         BufferPool &GetBufferPool() const { return buffer_pool_; }
 
@@ -36,6 +37,9 @@ namespace huadb {
 
         bool IsModificationSql() const { return is_modification_sql_; }
 
+        // 单个算子可使用的内存上限（字节）
+        size_t GetWorkMem() const { return work_mem_ * 1024; }
+
     private:
         BufferPool &buffer_pool_;
         Catalog &catalog_;
@@ -45,6 +49,7 @@ namespace huadb {
         IsolationLevel isolation_level_;
         cid_t cid_;
         bool is_modification_sql_;
+        size_t work_mem_;  // KB
     };
 
 }  // namespace huadb
@@ -47,6 +47,19 @@ class ExecutorFactory {
       }
       case OperatorType::PROJECTION: {
         auto projection_operator = std::dynamic_pointer_cast<const ProjectionOperator>(plan);
+        // 顺序扫描（及其上的过滤）之上的投影合并到扫描中，只物化投影后的记录
+        auto child_plan = plan->GetChildren()[0];
+        std::shared_ptr<OperatorExpression> predicate;
+        if (child_plan->GetType() == OperatorType::FILTER &&
+            child_plan->GetChildren()[0]->GetType() == OperatorType::SEQSCAN) {
+          predicate = std::dynamic_pointer_cast<const FilterOperator>(child_plan)->predicate_;
+          child_plan = child_plan->GetChildren()[0];
+        }
+        if (child_plan->GetType() == OperatorType::SEQSCAN) {
+          auto seqscan_operator = std::dynamic_pointer_cast<const SeqScanOperator>(child_plan);
+          return std::make_unique<SeqScanExecutor>(context, std::move(seqscan_operator), std::move(predicate),
+                                                   projection_operator->exprs_);
+        }
         auto child = CreateExecutor(context, plan->GetChildren()[0]);
         return std::make_unique<ProjectionExecutor>(context, std::move(projection_operator), std::move(child));
       }
@@ -77,6 +90,11 @@ class ExecutorFactory {
       }
       case OperatorType::FILTER: {
         auto filter_operator = std::dynamic_pointer_cast<const FilterOperator>(plan);
+        // 顺序扫描之上的过滤合并到扫描中，不满足条件的记录无需物化
+        if (plan->GetChildren()[0]->GetType() == OperatorType::SEQSCAN) {
+          auto seqscan_operator = std::dynamic_pointer_cast<const SeqScanOperator>(plan->GetChildren()[0]);
+          return std::make_unique<SeqScanExecutor>(context, std::move(seqscan_operator), filter_operator->predicate_);
+        }
         auto child = CreateExecutor(context, plan->GetChildren()[0]);
         return std::make_unique<FilterExecutor>(context, std::move(filter_operator), std::move(child));
       }
@@ -10,11 +10,256 @@ namespace huadb {
         children_[0]->Init();
         children_[1]->Init();
         // LAB 4 ADVANCED BEGIN
+        jobs_.clear();
+        build_file_ = nullptr;
+        probe_file_ = nullptr;
+        depth_ = 0;
+        Build();
     }
 
     std::shared_ptr<Record> HashJoinExecutor::Next() {
         // LAB 4 ADVANCED BEGIN
-        return nullptr;
+        auto join_type = plan_->join_type_;
+        while (true) {
+            if (match_ != NULL_ROW) {
+                auto row = match_;
+                match_ = next_[row];
+                matched_[row] = true;
+                probe_matched_ = true;
+                auto result = std::make_shared<Record>(*probe_record_);
+                result->Append(*build_records_[row]);
+                return result;
+            }
+            if (!probe_matched_ && (join_type == JoinType::LEFT || join_type == JoinType::FULL)) {
+                probe_matched_ = true;
+                auto result = std::make_shared<Record>(*probe_record_);
+                result->Append(Record(std::vector<Value>(plan_->GetChildren()[1]->OutputColumns().Length())));
+                return result;
+            }
+            probe_record_ = NextProbeRecord();
+            if (probe_record_ != nullptr) {
+                auto key = plan_->left_key_->Evaluate(probe_record_);
+                if (!partitions_.empty()) {
+                    auto partition = GetPartition(key);
+                    if (partition != 0 || !resident_) {
+                        // 留到该分区的连接中处理
+                        partitions_[partition].probe_->Append(*probe_record_);
+                        probe_matched_ = true;
+                        continue;
+                    }
+                }
+                probe_matched_ = false;
+                match_ = key.IsNull() ? NULL_ROW : Find(key, Hash(key));
+                continue;
+            }
+            if (join_type == JoinType::RIGHT || join_type == JoinType::FULL) {
+                while (unmatched_index_ < build_records_.size()) {
+                    auto row = unmatched_index_++;
+                    if (matched_[row]) {
+                        continue;
+                    }
+                    auto result = std::make_shared<Record>(
+                            std::vector<Value>(plan_->GetChildren()[0]->OutputColumns().Length()));
+                    result->Append(*build_records_[row]);
+                    // 与 NestedLoopJoinExecutor 一致，第一列取右侧记录的第一列
+                    result->SetValue(0, build_records_[row]->GetValue(0));
+                    return result;
+                }
+            }
+            if (!NextJob()) {
+                return nullptr;
+            }
+        }
+    }
+
+    uint32_t HashJoinExecutor::Hash(const Value &key) {
+        // 整数的 std::hash 为恒等映射，乘法散列后取高位，使连续的键均匀分布在各槽位
+        return static_cast<uint32_t>((std::hash<Value>()(key) * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+
+    size_t HashJoinExecutor::GetPartition(const Value &key) const {
+        if (key.IsNull()) {
+            return 0;
+        }
+        // 每层使用不同的种子，与槽位的哈希值相互独立，上一层同一分区中的键在下一层可以再次分开
+        uint64_t hash = std::hash<Value>()(key) ^ ((depth_ + 1) * 0xC2B2AE3D27D4EB4FULL);
+        hash = (hash ^ (hash >> 33)) * 0xFF51AFD7ED558CCDULL;
+        hash = (hash ^ (hash >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+        return (hash ^ (hash >> 33)) % SPILL_PARTITIONS;
+    }
+
+    void HashJoinExecutor::Build() {
+        ResetTable();
+        partitions_.clear();
+        resident_ = true;
+        while (auto record = NextBuildRecord()) {
+            auto key = plan_->right_key_->Evaluate(record);
+            if (!partitions_.empty()) {
+                auto partition = GetPartition(key);
+                if (partition != 0 || !resident_) {
+                    partitions_[partition].build_->Append(*record);
+                    continue;
+                }
+            }
+            Insert(std::move(record), std::move(key));
+            if (OverMemoryLimit() && depth_ < MAX_SPILL_DEPTH) {
+                if (partitions_.empty()) {
+                    Spill();
+                } else {
+                    SpillResidentPartition();
+                }
+            }
+        }
+        matched_.assign(build_records_.size(), false);
+        probe_record_ = nullptr;
+        match_ = NULL_ROW;
+        probe_matched_ = true;
+        unmatched_index_ = 0;
+    }
+
+    bool HashJoinExecutor::NextJob() {
+        auto join_type = plan_->join_type_;
+        bool keep_probe = join_type == JoinType::LEFT || join_type == JoinType::FULL;
+        bool keep_build = join_type == JoinType::RIGHT || join_type == JoinType::FULL;
+        for (size_t i = 0; i < partitions_.size(); i++) {
+            auto &partition = partitions_[i];
+            if (i == 0 && resident_) {
+                continue;
+            }
+            // 一侧为空的分区不会产生连接结果，外连接需要输出的一侧不为空时除外
+            bool has_build = partition.build_->GetRecordCount() > 0;
+            bool has_probe = partition.probe_->GetRecordCount() > 0;
+            if ((has_build && has_probe) || (has_probe && keep_probe) || (has_build && keep_build)) {
+                jobs_.push_back({std::move(partition.build_), std::move(partition.probe_), depth_ + 1});
+            }
+        }
+        partitions_.clear();
+        if (jobs_.empty()) {
+            return false;
+        }
+        auto job = std::move(jobs_.back());
+        jobs_.pop_back();
+        build_file_ = std::move(job.build_);
+        probe_file_ = std::move(job.probe_);
+        build_file_->Rewind();
+        probe_file_->Rewind();
+        depth_ = job.depth_;
+        Build();
+        return true;
+    }
+
+    std::shared_ptr<Record> HashJoinExecutor::NextBuildRecord() {
+        return build_file_ != nullptr ? build_file_->Next() : children_[1]->Next();
+    }
+
+    std::shared_ptr<Record> HashJoinExecutor::NextProbeRecord() {
+        return probe_file_ != nullptr ? probe_file_->Next() : children_[0]->Next();
+    }
+
+    void HashJoinExecutor::ResetTable() {
+        slots_.assign(16, {});
+        used_slots_ = 0;
+        build_records_.clear();
+        build_keys_.clear();
+        next_.clear();
+        memory_usage_ = 0;
+    }
+
+    void HashJoinExecutor::Insert(std::shared_ptr<Record> record, Value key) {
+        auto row = static_cast<uint32_t>(build_records_.size());
+        // 记录、行号引用与连接键占用的内存，超出内联长度的字符串另计
+        memory_usage_ += sizeof(Record) + sizeof(record) + sizeof(Value) + sizeof(uint32_t);
+        for (const auto &value : record->GetValues()) {
+            memory_usage_ += sizeof(Value) + (TypeUtil::IsString(value.GetType()) ? value.GetSize() : 0);
+        }
+        build_records_.push_back(std::move(record));
+        build_keys_.push_back(key);
+        next_.push_back(NULL_ROW);
+        if (key.IsNull()) {
+            return;
+        }
+        auto hash = Hash(key);
+        auto mask = slots_.size() - 1;
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            auto &slot = slots_[i];
+            if (slot.head_ == NULL_ROW) {
+                slot = {hash, row};
+                break;
+            }
+            // 连接键已存在时插入链表头部
+            if (slot.hash_ == hash && build_keys_[slot.head_].Equal(key)) {
+                next_[row] = slot.head_;
+                slot.head_ = row;
+                return;
+            }
+        }
+        // 装载因子不超过 1/2，保持探测序列较短
+        if (++used_slots_ * 2 > slots_.size()) {
+            Grow();
+        }
+    }
+
+    uint32_t HashJoinExecutor::Find(const Value &key, uint32_t hash) const {
+        auto mask = slots_.size() - 1;
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            const auto &slot = slots_[i];
+            if (slot.head_ == NULL_ROW) {
+                return NULL_ROW;
+            }
+            if (slot.hash_ == hash && build_keys_[slot.head_].Equal(key)) {
+                return slot.head_;
+            }
+        }
+    }
+
+    void HashJoinExecutor::Grow() {
+        std::vector<Slot> slots(slots_.size() * 2);
+        auto mask = slots.size() - 1;
+        for (const auto &slot : slots_) {
+            if (slot.head_ == NULL_ROW) {
+                continue;
+            }
+            auto i = slot.hash_ & mask;
+            while (slots[i].head_ != NULL_ROW) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+        slots_ = std::move(slots);
+    }
+
+    bool HashJoinExecutor::OverMemoryLimit() const {
+        return memory_usage_ + slots_.size() * sizeof(Slot) > context_.GetWorkMem();
+    }
+
+    void HashJoinExecutor::Spill() {
+        partitions_.resize(SPILL_PARTITIONS);
+        for (auto &partition : partitions_) {
+            partition.build_ = std::make_unique<TempFile>();
+            partition.probe_ = std::make_unique<TempFile>();
+        }
+        auto records = std::move(build_records_);
+        auto keys = std::move(build_keys_);
+        ResetTable();
+        for (size_t row = 0; row < records.size(); row++) {
+            auto partition = GetPartition(keys[row]);
+            if (partition == 0) {
+                Insert(std::move(records[row]), std::move(keys[row]));
+            } else {
+                partitions_[partition].build_->Append(*records[row]);
+            }
+        }
+        if (OverMemoryLimit()) {
+            SpillResidentPartition();
+        }
+    }
+
+    void HashJoinExecutor::SpillResidentPartition() {
+        resident_ = false;
+        for (const auto &record : build_records_) {
+            partitions_[0].build_->Append(*record);
+        }
+        ResetTable();
     }
 
 }  // namespace huadb
@@ -1,12 +1,19 @@
 #pragma once
 
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include "executors/executor.h"
 #include "operators/hash_join_operator.h"
+#include "storage/temp_file.h"
 
 namespace huadb {
 
+    // 哈希连接：先读入右侧子节点的全部记录建立哈希表，再逐条读取左侧记录探测
+    // 哈希表使用开放定址（线性探测），槽位只存放 32 位哈希值与行号共 8 字节，连接键相同的行通过 next_ 串成链，
+    // 探测时只在哈希值相同的槽位上比较连接键。连接键为空的记录不与任何记录匹配
+    // 右侧记录超过 work_mem 时按连接键的哈希值将两侧记录分区写入临时文件（混合哈希连接：第 0 个分区尽量留在内存中，
+    // 其余分区在探测完成后逐个读回连接），单个分区仍然过大时以新的哈希种子递归分区
     class HashJoinExecutor : public Executor {
     public:
         HashJoinExecutor(ExecutorContext &context, std::shared_ptr<const HashJoinOperator> plan,
@@ -17,7 +24,88 @@ namespace huadb {
         std::shared_ptr<Record> Next() override;
 
     private:
+        static constexpr uint32_t NULL_ROW = UINT32_MAX;
+        // 每次分区的分区数
+        static constexpr size_t SPILL_PARTITIONS = 16;
+        // 最大分区层数，达到后不再分区（如大量记录的连接键相同），直接在内存中连接
+        static constexpr size_t MAX_SPILL_DEPTH = 3;
+
+        struct Slot {
+            uint32_t hash_;
+            uint32_t head_ = NULL_ROW;  // 该连接键的第一行，为 NULL_ROW 时槽位为空
+        };
+
+        // 溢出到临时文件的一个分区
+        struct Partition {
+            std::unique_ptr<TempFile> build_;
+            std::unique_ptr<TempFile> probe_;
+        };
+
+        // 待连接的一对输入，文件为空指针时读取子节点
+        struct Job {
+            std::unique_ptr<TempFile> build_;
+            std::unique_ptr<TempFile> probe_;
+            size_t depth_;
+        };
+
+        static uint32_t Hash(const Value &key);
+
+        // 连接键在第 depth_ 层分区中所属的分区，空值属于第 0 个分区
+        size_t GetPartition(const Value &key) const;
+
+        // 读入当前任务的右侧记录建立哈希表，超过内存上限时分区
+        void Build();
+
+        // 开始下一个溢出分区的连接，没有时返回 false
+        bool NextJob();
+
+        std::shared_ptr<Record> NextBuildRecord();
+
+        std::shared_ptr<Record> NextProbeRecord();
+
+        // 清空哈希表
+        void ResetTable();
+
+        // 将右侧记录加入哈希表
+        void Insert(std::shared_ptr<Record> record, Value key);
+
+        // 查找连接键等于 key 的第一行，不存在时返回 NULL_ROW
+        uint32_t Find(const Value &key, uint32_t hash) const;
+
+        // 槽位数翻倍并按保存的哈希值重新插入
+        void Grow();
+
+        // 哈希表占用的内存是否超过 work_mem
+        bool OverMemoryLimit() const;
+
+        // 首次超过内存上限时创建分区，只将第 0 个分区的记录留在内存中，其余写入临时文件
+        void Spill();
+
+        // 第 0 个分区也超过内存上限时将其写入临时文件
+        void SpillResidentPartition();
+
         std::shared_ptr<const HashJoinOperator> plan_;
+
+        std::vector<Slot> slots_;                            // 槽位数为 2 的幂
+        size_t used_slots_ = 0;
+        std::vector<std::shared_ptr<Record>> build_records_;  // 右侧记录，下标为行号
+        std::vector<Value> build_keys_;                      // 各行的连接键
+        std::vector<uint32_t> next_;                         // 连接键相同的下一行
+        std::vector<bool> matched_;                          // 各行是否已匹配，用于右连接和全连接
+        size_t memory_usage_ = 0;                            // 哈希表中记录占用的内存估计
+
+        // 当前任务的输入与分区
+        std::unique_ptr<TempFile> build_file_;
+        std::unique_ptr<TempFile> probe_file_;
+        size_t depth_ = 0;
+        std::vector<Partition> partitions_;  // 未分区时为空
+        bool resident_ = true;               // 分区后第 0 个分区是否留在内存中
+        std::vector<Job> jobs_;              // 待连接的溢出分区
+
+        std::shared_ptr<Record> probe_record_;  // 当前的左侧记录
+        uint32_t match_ = NULL_ROW;             // 当前左侧记录的下一条匹配行
+        bool probe_matched_ = false;            // 当前左侧记录是否已有匹配
+        size_t unmatched_index_ = 0;            // 输出未匹配的右侧记录时的下一行
     };
 
 }  // namespace huadb
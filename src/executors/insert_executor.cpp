@@ -17,7 +17,32 @@ namespace huadb {
         if (finished_) {
             return nullptr;
         }
+        // 通过 context_ 获取正确的锁，加锁失败时抛出异常
+        // LAB 3 BEGIN
+        auto &lock_manager = context_.GetLockManager();
+        auto xid = context_.GetXid();
+        auto oid = table_->GetOid();
+
+        if (!lock_manager.LockTable(xid, LockType::IX, oid)) {
+            throw DbException("insert set table lock IX failed");
+        }
+
+        // 攒够一批记录后交给表批量插入，按页面合并日志，避免逐条获取页面和写日志
+        // 没有空闲页面时，先回收早于所有活跃事务快照删除的记录所占的空间
+        auto oldest_xid = context_.GetTransactionManager().GetOldestXid();
         uint32_t count = 0;
+        std::vector<std::shared_ptr<Record>> batch;
+        batch.reserve(INSERT_BATCH_SIZE);
+        auto insert_batch = [&]() {
+            auto rids = table_->InsertRecords(batch, xid, context_.GetCid(), true, oldest_xid);
+            for (const auto &rid: rids) {
+                if (!lock_manager.LockRow(xid, LockType::X, oid, rid)) {
+                    throw DbException("insert set row lock X failed");
+                }
+            }
+            count += rids.size();
+            batch.clear();
+        };
         while (auto record = children_[0]->Next()) {
             std::vector<Value> values(column_list_.Length());
             const auto &insert_columns = plan_->GetInsertColumns().GetColumns();
@@ -25,25 +50,13 @@ namespace huadb {
                 auto column_index = column_list_.GetColumnIndex(insert_columns[i].GetName());
                 values[column_index] = record->GetValue(i);
             }
-            auto table_record = std::make_shared<Record>(std::move(values));
-            // 通过 context_ 获取正确的锁，加锁失败时抛出异常
-            // LAB 3 BEGIN
-
-            auto &lock_manager = context_.GetLockManager();
-            auto xid = context_.GetXid();
-            auto oid = table_->GetOid();
-
-            if (!lock_manager.LockTable(xid, LockType::IX, oid)) {
-                throw DbException("insert set table lock IX failed");
+            batch.push_back(std::make_shared<Record>(std::move(values)));
+            if (batch.size() == INSERT_BATCH_SIZE) {
+                insert_batch();
             }
-
-            auto rid = table_->InsertRecord(std::move(table_record), context_.GetXid(), context_.GetCid(), true);
-
-            if (!lock_manager.LockRow(xid, LockType::X, oid, rid)) {
-                throw DbException("insert set row lock X failed");
-            }
-
-            count++;
+        }
+        if (!batch.empty()) {
+            insert_batch();
         }
         finished_ = true;
         return std::make_shared<Record>(std::vector{Value(count)});
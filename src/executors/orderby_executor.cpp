@@ -1,74 +1,64 @@
 #include "executors/orderby_executor.h"
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include "binder/order_by.h"
 #include "common/value.h"
 
 namespace huadb {
-    bool Less(const std::pair<std::shared_ptr<Record>, Value> &record1,
-              const std::pair<std::shared_ptr<Record>, Value> &record2) {
-        return record1.second.Less(record2.second);
-    }
-
-    bool Greater(const std::pair<std::shared_ptr<Record>, Value> &record1,
-                 const std::pair<std::shared_ptr<Record>, Value> &record2) {
-        return record1.second.Greater(record2.second);
-    }
 
     OrderByExecutor::OrderByExecutor(ExecutorContext &context, std::shared_ptr<const OrderByOperator> plan,
                                      std::shared_ptr<Executor> child)
-            : Executor(context, {std::move(child)}), plan_(std::move(plan)), index_(0) {}
+            : Executor(context, {std::move(child)}), plan_(std::move(plan)) {}
 
     void OrderByExecutor::Init() {
         children_[0]->Init();
-        std::shared_ptr<Record> record = children_[0]->Next();
+        buffer_.clear();
+        memory_usage_ = 0;
+        index_ = 0;
+        runs_.clear();
+        merging_ = false;
 
-        while (record != nullptr) {
-            sorted_records_.emplace_back(record, Value());
-            record = children_[0]->Next();
-        }
-
-        size_t count = 1;
-        for (const auto &order_by: plan_->order_bys_) {
-            const auto order_type = order_by.first;
-            const auto &op_expr = order_by.second;
-
-            // 设置Value
-            for (auto &iter: sorted_records_) {
-                iter.second = op_expr->Evaluate(iter.first);
+        while (auto record = children_[0]->Next()) {
+            SortEntry entry{std::move(record), {}};
+            entry.keys_.reserve(plan_->order_bys_.size());
+            for (const auto &order_by: plan_->order_bys_) {
+                entry.keys_.push_back(order_by.second->Evaluate(entry.record_));
             }
-
-            if (count == 1) {
-                if (order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT) {
-                    std::sort(sorted_records_.begin(), sorted_records_.end(), Less);
-                } else if (order_type == OrderByType::DESC) {
-                    std::sort(sorted_records_.begin(), sorted_records_.end(), Greater);
-                }
-            } else {
-                if (order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT) {
-                    for (int i = 1; i < indices_.size(); ++i) {
-                        std::sort(sorted_records_.begin() + indices_[i - 1], sorted_records_.begin() + indices_[i],
-                                  Less);
-                    }
-                    std::sort(sorted_records_.begin() + indices_.back(), sorted_records_.end(), Less);
-                } else if (order_type == OrderByType::DESC) {
-                    for (int i = 1; i < indices_.size(); ++i) {
-                        std::sort(sorted_records_.begin() + indices_[i - 1], sorted_records_.begin() + indices_[i],
-                                  Greater);
-                    }
-                    std::sort(sorted_records_.begin() + indices_.back(), sorted_records_.end(), Greater);
+            // 记录、排序键与缓冲区中的引用占用的内存，超出内联长度的字符串另计
+            memory_usage_ += sizeof(SortEntry) + sizeof(Record);
+            for (const auto &values: {std::cref(entry.record_->GetValues()), std::cref(entry.keys_)}) {
+                for (const auto &value: values.get()) {
+                    memory_usage_ += sizeof(Value) + (TypeUtil::IsString(value.GetType()) ? value.GetSize() : 0);
                 }
             }
-
-            indices_.clear();
-            indices_.emplace_back(0);
-            for (int i = 1; i < sorted_records_.size(); ++i) {
-                if (!sorted_records_[i].second.Equal(sorted_records_[i - 1].second)) {
-                    indices_.emplace_back(i);
-                }
+            buffer_.push_back(std::move(entry));
+            if (memory_usage_ > context_.GetWorkMem()) {
+                SpillRun();
             }
+        }
 
-            ++count;
+        if (runs_.empty()) {
+            SortBuffer();
+            return;
+        }
+        if (!buffer_.empty()) {
+            SpillRun();
+        }
+        // 有序段过多时每次将相邻的 MERGE_FAN_IN 个有序段归并为一个，保持有序段的先后顺序
+        while (runs_.size() > MERGE_FAN_IN) {
+            auto runs = std::move(runs_);
+            std::vector<std::unique_ptr<TempFile>> merged_runs;
+            for (size_t begin = 0; begin < runs.size(); begin += MERGE_FAN_IN) {
+                auto end = std::min(begin + MERGE_FAN_IN, runs.size());
+                runs_.assign(std::make_move_iterator(runs.begin() + begin),
+                             std::make_move_iterator(runs.begin() + end));
+                merged_runs.push_back(MergeRuns());
+            }
+            runs_ = std::move(merged_runs);
         }
+        StartMerge();
+        merging_ = true;
     }
 
     std::shared_ptr<Record> OrderByExecutor::Next() {
@@ -76,11 +66,135 @@ namespace huadb {
         // 通过 OperatorExpression 的 Evaluate 函数获取 Value 的值
         // 通过 Value 的 Less, Equal, Greater 函数比较 Value 的值
         // LAB 4 BEGIN
-        while (index_ != sorted_records_.size()) {
-            auto record = sorted_records_[index_].first;
-            ++index_;
-            return record;
+        if (merging_) {
+            SortEntry entry;
+            if (!PopMerge(entry)) {
+                return nullptr;
+            }
+            return std::move(entry.record_);
+        }
+        if (index_ < buffer_.size()) {
+            return buffer_[index_++].record_;
         }
         return nullptr;
     }
+
+    int OrderByExecutor::Compare(const std::vector<Value> &lhs, const std::vector<Value> &rhs) const {
+        for (size_t i = 0; i < lhs.size(); i++) {
+            const auto &left = lhs[i];
+            const auto &right = rhs[i];
+            int result = 0;
+            if (left.IsNull() || right.IsNull()) {
+                result = static_cast<int>(left.IsNull()) - static_cast<int>(right.IsNull());
+            } else if (left.Less(right)) {
+                result = -1;
+            } else if (left.Greater(right)) {
+                result = 1;
+            }
+            if (result != 0) {
+                return plan_->order_bys_[i].first == OrderByType::DESC ? -result : result;
+            }
+        }
+        return 0;
+    }
+
+    void OrderByExecutor::SortBuffer() {
+        std::stable_sort(buffer_.begin(), buffer_.end(), [this](const SortEntry &lhs, const SortEntry &rhs) {
+            return Compare(lhs.keys_, rhs.keys_) < 0;
+        });
+    }
+
+    void OrderByExecutor::SpillRun() {
+        SortBuffer();
+        auto run = std::make_unique<TempFile>();
+        for (auto &entry: buffer_) {
+            AppendEntry(*run, std::move(entry));
+        }
+        runs_.push_back(std::move(run));
+        buffer_.clear();
+        memory_usage_ = 0;
+    }
+
+    void OrderByExecutor::AppendEntry(TempFile &run, SortEntry entry) {
+        auto values = entry.record_->GetValues();
+        values.insert(values.end(), std::make_move_iterator(entry.keys_.begin()),
+                      std::make_move_iterator(entry.keys_.end()));
+        run.Append(Record(std::move(values)));
+    }
+
+    std::unique_ptr<TempFile> OrderByExecutor::MergeRuns() {
+        if (runs_.size() == 1) {
+            return std::move(runs_[0]);
+        }
+        StartMerge();
+        auto merged = std::make_unique<TempFile>();
+        SortEntry entry;
+        while (PopMerge(entry)) {
+            AppendEntry(*merged, std::move(entry));
+        }
+        return merged;
+    }
+
+    void OrderByExecutor::StartMerge() {
+        auto run_count = runs_.size();
+        heads_.assign(run_count, {});
+        for (size_t run = 0; run < run_count; run++) {
+            runs_[run]->Rewind();
+            ReadRun(run);
+        }
+        // 内部节点初始化为虚拟的最小有序段 run_count，之后依次加入各有序段
+        tree_.assign(run_count, run_count);
+        for (size_t run = run_count; run-- > 0;) {
+            Adjust(run);
+        }
+    }
+
+    bool OrderByExecutor::PopMerge(SortEntry &entry) {
+        auto winner = tree_[0];
+        if (heads_[winner].record_ == nullptr) {
+            return false;
+        }
+        entry = std::move(heads_[winner]);
+        ReadRun(winner);
+        Adjust(winner);
+        return true;
+    }
+
+    void OrderByExecutor::ReadRun(size_t run) {
+        auto record = runs_[run]->Next();
+        if (record == nullptr) {
+            heads_[run] = {};
+            return;
+        }
+        auto values = record->GetValues();
+        auto key_begin = values.end() - plan_->order_bys_.size();
+        heads_[run].keys_.assign(std::make_move_iterator(key_begin), std::make_move_iterator(values.end()));
+        values.erase(key_begin, values.end());
+        heads_[run].record_ = std::make_shared<Record>(std::move(values));
+    }
+
+    bool OrderByExecutor::Beats(size_t lhs, size_t rhs) const {
+        auto run_count = runs_.size();
+        if (lhs == run_count || rhs == run_count) {
+            return lhs == run_count;
+        }
+        if (heads_[lhs].record_ == nullptr || heads_[rhs].record_ == nullptr) {
+            return heads_[rhs].record_ == nullptr;
+        }
+        // 排序键相同时先写出的有序段优先，与输入顺序一致
+        auto result = Compare(heads_[lhs].keys_, heads_[rhs].keys_);
+        return result < 0 || (result == 0 && lhs < rhs);
+    }
+
+    void OrderByExecutor::Adjust(size_t run) {
+        auto winner = run;
+        for (auto node = (run + runs_.size()) / 2; node > 0; node /= 2) {
+            // 节点中的败者胜过当前胜者时二者交换，败者留在节点中
+            if (Beats(tree_[node], winner)) {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
 }  // namespace huadb
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <memory>
+
 #include "executors/executor.h"
 #include "operators/orderby_operator.h"
+#include "storage/temp_file.h"
 
 namespace huadb {
 
+    // 排序：每条记录的排序键只计算一次，与记录一起放入排序缓冲区
+    // 缓冲区占用的内存超过 work_mem 时将其排序后作为一个有序段（run）写入临时文件，记录之后依次存放排序键。
+    // 输入读完后若没有写出过有序段则直接在内存中排序输出；否则用败者树多路归并各有序段，逐条输出。
+    // 有序段多于 MERGE_FAN_IN 个时先归并成较少的有序段，使同时打开的文件缓冲区数量有上限。
+    // 与 PostgreSQL 一致，空值大于任何非空值
     class OrderByExecutor : public Executor {
     public:
         OrderByExecutor(ExecutorContext &context, std::shared_ptr<const OrderByOperator> plan,
@@ -15,10 +23,54 @@ namespace huadb {
         std::shared_ptr<Record> Next() override;
 
     private:
+        // 一次归并的最大有序段数
+        static constexpr size_t MERGE_FAN_IN = 64;
+
+        struct SortEntry {
+            std::shared_ptr<Record> record_;
+            std::vector<Value> keys_;
+        };
+
+        // 按排序键比较，返回负数、0 或正数
+        int Compare(const std::vector<Value> &lhs, const std::vector<Value> &rhs) const;
+
+        // 按排序键稳定排序缓冲区
+        void SortBuffer();
+
+        // 将排序缓冲区排序后写成一个有序段并清空
+        void SpillRun();
+
+        // 将记录与其排序键写入有序段
+        static void AppendEntry(TempFile &run, SortEntry entry);
+
+        // 将 runs_ 中的全部有序段归并为一个
+        std::unique_ptr<TempFile> MergeRuns();
+
+        // 开始归并 runs_ 中的全部有序段
+        void StartMerge();
+
+        // 取出归并结果的下一条记录，归并完成时返回 false
+        bool PopMerge(SortEntry &entry);
+
+        // 读出有序段 run 的下一条记录作为其当前记录
+        void ReadRun(size_t run);
+
+        // 有序段 lhs 的当前记录是否排在 rhs 之前，已读完的有序段排在最后
+        bool Beats(size_t lhs, size_t rhs) const;
+
+        // 有序段 run 的当前记录改变后从其叶节点向上调整败者树
+        void Adjust(size_t run);
+
         std::shared_ptr<const OrderByOperator> plan_;
-        std::vector<std::pair<std::shared_ptr<Record>, Value>> sorted_records_;
-        std::vector<size_t> indices_;
-        int index_;
+
+        std::vector<SortEntry> buffer_;  // 排序缓冲区
+        size_t memory_usage_ = 0;        // 排序缓冲区占用的内存估计
+        size_t index_ = 0;               // 内存中排序时下一条输出的记录
+
+        std::vector<std::unique_ptr<TempFile>> runs_;  // 已写出的有序段
+        bool merging_ = false;                         // 是否通过归并输出
+        std::vector<SortEntry> heads_;                 // 各有序段的当前记录，读完时记录为空指针
+        std::vector<size_t> tree_;                     // 败者树，tree_[0] 为胜者，其余内部节点存放败者
     };
 
 }  // namespace huadb
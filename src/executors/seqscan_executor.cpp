@@ -5,12 +5,37 @@
 
 namespace huadb {
 
-    SeqScanExecutor::SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan)
-            : Executor(context, {}), plan_(std::move(plan)) {}
+    SeqScanExecutor::SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan,
+                                     std::shared_ptr<OperatorExpression> predicate,
+                                     std::vector<std::shared_ptr<OperatorExpression>> projection)
+            : Executor(context, {}),
+              plan_(std::move(plan)),
+              predicate_(std::move(predicate)),
+              projection_(std::move(projection)) {}
 
     void SeqScanExecutor::Init() {
         auto table = context_.GetCatalog().GetTable(plan_->GetTableOid());
         scan_ = std::make_unique<TableScan>(context_.GetBufferPool(), table, Rid{table->GetFirstPageId(), 0});
+        if (predicate_ == nullptr && projection_.empty()) {
+            return;
+        }
+        visitor_ = [this](const TupleView &tuple) -> std::shared_ptr<Record> {
+            if (predicate_ != nullptr) {
+                auto value = predicate_->EvaluateTuple(tuple);
+                if (value.IsNull() || !value.GetValue<bool>()) {
+                    return nullptr;
+                }
+            }
+            if (projection_.empty()) {
+                return tuple.Materialize();
+            }
+            std::vector<Value> values;
+            values.reserve(projection_.size());
+            for (const auto &expr: projection_) {
+                values.push_back(expr->EvaluateTuple(tuple));
+            }
+            return std::make_shared<Record>(std::move(values), tuple.GetRid());
+        };
     }
 
     std::shared_ptr<Record> SeqScanExecutor::Next() {
@@ -34,7 +59,7 @@ namespace huadb {
         }
 
         auto table = context_.GetCatalog().GetTable(plan_->GetTableOid());
-        auto record = scan_->GetNextRecord(xid, iso_level, cid, active_xids);
+        auto record = scan_->GetNextRecord(xid, iso_level, cid, active_xids, visitor_);
         auto oid = table->GetOid();
         auto &lock_manager = context_.GetLockManager();
 
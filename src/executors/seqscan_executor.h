@@ -1,13 +1,17 @@
 #pragma once
 
 #include "executors/executor.h"
+#include "operators/expressions/expression.h"
 #include "operators/seqscan_operator.h"
 
 namespace huadb {
 
     class SeqScanExecutor : public Executor {
     public:
-        SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan);
+        // predicate、projection: 合并到扫描中的过滤条件和投影，直接在页面中的记录上求值，只物化满足条件的记录的投影结果
+        SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan,
+                        std::shared_ptr<OperatorExpression> predicate = nullptr,
+                        std::vector<std::shared_ptr<OperatorExpression>> projection = {});
 
         void Init() override;
 
@@ -16,6 +20,9 @@ namespace huadb {
     private:
         std::shared_ptr<const SeqScanOperator> plan_;
         std::unique_ptr<TableScan> scan_;
+        std::shared_ptr<OperatorExpression> predicate_;
+        std::vector<std::shared_ptr<OperatorExpression>> projection_;
+        TupleVisitor visitor_;
     };
 
 }  // namespace huadb
@@ -17,6 +17,8 @@ namespace huadb {
             return nullptr;
         }
         uint32_t count = 0;
+        // 新版本没有空闲页面可放时，先回收早于所有活跃事务快照删除的记录所占的空间
+        auto oldest_xid = context_.GetTransactionManager().GetOldestXid();
         while (auto record = children_[0]->Next()) {
             std::vector<Value> values;
             for (const auto &expr : plan_->update_exprs_) {
@@ -33,7 +35,8 @@ namespace huadb {
                 throw DbException("update set table lock IX failed");
             }
 
-            auto rid = table_->UpdateRecord(record->GetRid(), context_.GetXid(), context_.GetCid(), new_record, true);
+            auto rid = table_->UpdateRecord(record->GetRid(), context_.GetXid(), context_.GetCid(), new_record, true,
+                                            oldest_xid);
 
             if (!lock_manager.LockRow(xid, LockType::X, oid, rid)) {
                 throw DbException("update set row lock X failed");
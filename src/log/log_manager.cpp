@@ -1,5 +1,10 @@
 #include "log/log_manager.h"
 
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <vector>
+
 #include "common/exceptions.h"
 #include "log/log_records/log_records.h"
 #include "table/table_page.h"
@@ -16,6 +21,7 @@ namespace huadb {
     lsn_t LogManager::GetNextLSN() const { return next_lsn_; }
 
     void LogManager::Clear() {
+        std::unique_lock flush_lock(flush_mutex_);
         std::unique_lock lock(log_buffer_mutex_);
         log_buffer_.clear();
     }
@@ -23,6 +29,7 @@ namespace huadb {
     void LogManager::Flush() { Flush(NULL_LSN); }
 
     void LogManager::SetDirty(oid_t oid, pageid_t page_id, lsn_t lsn) {
+        std::unique_lock lock(dpt_mutex_);
         if (dpt_.find({oid, page_id}) == dpt_.end()) {
             dpt_[{oid, page_id}] = lsn;
         }
@@ -30,6 +37,7 @@ namespace huadb {
 
     lsn_t LogManager::AppendInsertLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t slot_id, db_size_t offset,
                                       db_size_t size, char *new_record) {
+        std::unique_lock lock(log_buffer_mutex_);
         if (att_.find(xid) == att_.end()) {
             throw DbException(std::to_string(xid) + " does not exist in att (in AppendInsertLog)");
         }
@@ -38,17 +46,31 @@ namespace huadb {
         lsn_t lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
         log->SetLSN(lsn);
         att_[xid] = lsn;
-        {
-            std::unique_lock lock(log_buffer_mutex_);
-            log_buffer_.push_back(std::move(log));
-        }
-        if (dpt_.find({oid, page_id}) == dpt_.end()) {
-            dpt_[{oid, page_id}] = lsn;
+        log_buffer_.push_back(std::move(log));
+        lock.unlock();
+        SetDirty(oid, page_id, lsn);
+        return lsn;
+    }
+
+    lsn_t LogManager::AppendBulkInsertLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t first_slot_id,
+                                          std::vector<Slot> slots, db_size_t upper, std::vector<char> records) {
+        std::unique_lock lock(log_buffer_mutex_);
+        if (att_.find(xid) == att_.end()) {
+            throw DbException(std::to_string(xid) + " does not exist in att (in AppendBulkInsertLog)");
         }
+        auto log = std::make_shared<BulkInsertLog>(NULL_LSN, xid, att_.at(xid), oid, page_id, first_slot_id,
+                                                   std::move(slots), upper, std::move(records));
+        lsn_t lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
+        log->SetLSN(lsn);
+        att_[xid] = lsn;
+        log_buffer_.push_back(std::move(log));
+        lock.unlock();
+        SetDirty(oid, page_id, lsn);
         return lsn;
     }
 
     lsn_t LogManager::AppendDeleteLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t slot_id) {
+        std::unique_lock lock(log_buffer_mutex_);
         if (att_.find(xid) == att_.end()) {
             throw DbException(std::to_string(xid) + " does not exist in att (in AppendDeleteLog)");
         }
@@ -56,17 +78,32 @@ namespace huadb {
         lsn_t lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
         log->SetLSN(lsn);
         att_[xid] = lsn;
-        {
-            std::unique_lock lock(log_buffer_mutex_);
-            log_buffer_.push_back(std::move(log));
-        }
-        if (dpt_.find({oid, page_id}) == dpt_.end()) {
-            dpt_[{oid, page_id}] = lsn;
+        log_buffer_.push_back(std::move(log));
+        lock.unlock();
+        SetDirty(oid, page_id, lsn);
+        return lsn;
+    }
+
+    lsn_t LogManager::AppendUpdateLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t old_slot_id,
+                                      slotid_t new_slot_id, db_size_t offset, db_size_t size,
+                                      const char *new_record) {
+        std::unique_lock lock(log_buffer_mutex_);
+        if (att_.find(xid) == att_.end()) {
+            throw DbException(std::to_string(xid) + " does not exist in att (in AppendUpdateLog)");
         }
+        auto log = std::make_shared<UpdateLog>(NULL_LSN, xid, att_.at(xid), oid, page_id, old_slot_id, new_slot_id,
+                                               offset, std::vector<char>(new_record, new_record + size));
+        lsn_t lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
+        log->SetLSN(lsn);
+        att_[xid] = lsn;
+        log_buffer_.push_back(std::move(log));
+        lock.unlock();
+        SetDirty(oid, page_id, lsn);
         return lsn;
     }
 
     lsn_t LogManager::AppendNewPageLog(xid_t xid, oid_t oid, pageid_t prev_page_id, pageid_t page_id) {
+        std::unique_lock lock(log_buffer_mutex_);
         if (xid != DDL_XID && att_.find(xid) == att_.end()) {
             throw DbException(std::to_string(xid) + " does not exist in att (in AppendNewPageLog)");
         }
@@ -83,20 +120,58 @@ namespace huadb {
         if (xid != DDL_XID) {
             att_[xid] = lsn;
         }
+        log_buffer_.push_back(std::move(log));
+        lock.unlock();
+        SetDirty(oid, page_id, lsn);
+        if (prev_page_id != NULL_PAGE_ID) {
+            SetDirty(oid, prev_page_id, lsn);
+        }
+        return lsn;
+    }
+
+    lsn_t LogManager::AppendCompactPageLog(oid_t oid, pageid_t page_id, std::vector<slotid_t> dead_slots) {
+        auto log = std::make_shared<CompactPageLog>(NULL_LSN, oid, page_id, std::move(dead_slots));
+        lsn_t lsn;
         {
             std::unique_lock lock(log_buffer_mutex_);
+            lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
+            log->SetLSN(lsn);
             log_buffer_.push_back(std::move(log));
         }
-        if (dpt_.find({oid, page_id}) == dpt_.end()) {
-            dpt_[{oid, page_id}] = lsn;
+        SetDirty(oid, page_id, lsn);
+        return lsn;
+    }
+
+    lsn_t LogManager::AppendTruncateLog(oid_t oid, pageid_t page_count) {
+        auto log = std::make_shared<TruncateLog>(NULL_LSN, oid, page_count);
+        lsn_t lsn;
+        {
+            std::unique_lock lock(log_buffer_mutex_);
+            lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
+            log->SetLSN(lsn);
+            log_buffer_.push_back(std::move(log));
         }
-        if (prev_page_id != NULL_PAGE_ID && dpt_.find({oid, prev_page_id}) == dpt_.end()) {
-            dpt_[{oid, prev_page_id}] = lsn;
+        {
+            // 被截断的页面不会再写回，留在脏页表中会使检查点的重做起点无法推进
+            std::unique_lock lock(dpt_mutex_);
+            EraseTruncatedPages(oid, page_count);
         }
+        SetDirty(oid, page_count - 1, lsn);
         return lsn;
     }
 
+    void LogManager::EraseTruncatedPages(oid_t oid, pageid_t page_count) {
+        for (auto iter = dpt_.begin(); iter != dpt_.end();) {
+            if (iter->first.table_oid_ == oid && iter->first.page_id_ >= page_count) {
+                iter = dpt_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
     lsn_t LogManager::AppendBeginLog(xid_t xid) {
+        std::unique_lock lock(log_buffer_mutex_);
         if (att_.find(xid) != att_.end()) {
             throw DbException(std::to_string(xid) + " already exists in att");
         }
@@ -104,59 +179,66 @@ namespace huadb {
         lsn_t lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
         log->SetLSN(lsn);
         att_[xid] = lsn;
-        {
-            std::unique_lock lock(log_buffer_mutex_);
-            log_buffer_.push_back(std::move(log));
-        }
+        log_buffer_.push_back(std::move(log));
         return lsn;
     }
 
     lsn_t LogManager::AppendCommitLog(xid_t xid) {
+        std::unique_lock lock(log_buffer_mutex_);
         if (att_.find(xid) == att_.end()) {
             throw DbException(std::to_string(xid) + " does not exist in att (in AppendCommitLog)");
         }
         auto log = std::make_shared<CommitLog>(NULL_LSN, xid, att_.at(xid));
         lsn_t lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
         log->SetLSN(lsn);
-        {
-            std::unique_lock lock(log_buffer_mutex_);
-            log_buffer_.push_back(std::move(log));
-        }
+        log_buffer_.push_back(std::move(log));
+        lock.unlock();
         Flush(lsn);
+        lock.lock();
         att_.erase(xid);
         return lsn;
     }
 
     lsn_t LogManager::AppendRollbackLog(xid_t xid) {
+        std::unique_lock lock(log_buffer_mutex_);
         if (att_.find(xid) == att_.end()) {
             throw DbException(std::to_string(xid) + " does not exist in att (in AppendRollbackLog)");
         }
         auto log = std::make_shared<RollbackLog>(NULL_LSN, xid, att_.at(xid));
         lsn_t lsn = next_lsn_.fetch_add(log->GetSize(), std::memory_order_relaxed);
         log->SetLSN(lsn);
-        {
-            std::unique_lock lock(log_buffer_mutex_);
-            log_buffer_.push_back(std::move(log));
-        }
+        log_buffer_.push_back(std::move(log));
+        lock.unlock();
         Flush(lsn);
+        lock.lock();
         att_.erase(xid);
         return lsn;
     }
 
     lsn_t LogManager::Checkpoint(bool async) {
         auto begin_checkpoint_log = std::make_shared<BeginCheckpointLog>(NULL_LSN, NULL_XID, NULL_LSN);
-        lsn_t begin_lsn = next_lsn_.fetch_add(begin_checkpoint_log->GetSize(), std::memory_order_relaxed);
-        begin_checkpoint_log->SetLSN(begin_lsn);
+        lsn_t begin_lsn;
         {
             std::unique_lock lock(log_buffer_mutex_);
+            begin_lsn = next_lsn_.fetch_add(begin_checkpoint_log->GetSize(), std::memory_order_relaxed);
+            begin_checkpoint_log->SetLSN(begin_lsn);
             log_buffer_.push_back(std::move(begin_checkpoint_log));
         }
 
-        auto end_checkpoint_log = std::make_shared<EndCheckpointLog>(NULL_LSN, NULL_XID, NULL_LSN, att_, dpt_);
-        lsn_t end_lsn = next_lsn_.fetch_add(end_checkpoint_log->GetSize(), std::memory_order_relaxed);
-        end_checkpoint_log->SetLSN(end_lsn);
+        std::unordered_map<TablePageid, lsn_t> dpt;
+        {
+            std::unique_lock lock(dpt_mutex_);
+            dpt = dpt_;
+        }
+        // 复制脏页表之前已从中移除的页面需先落盘，检查点之后的恢复不会再重做它们
+        // 先复制再同步：复制之后才被写回并移除的页面仍在检查点的脏页表中
+        disk_.SyncPages();
+        lsn_t end_lsn;
         {
             std::unique_lock lock(log_buffer_mutex_);
+            auto end_checkpoint_log = std::make_shared<EndCheckpointLog>(NULL_LSN, NULL_XID, NULL_LSN, att_, dpt);
+            end_lsn = next_lsn_.fetch_add(end_checkpoint_log->GetSize(), std::memory_order_relaxed);
+            end_checkpoint_log->SetLSN(end_lsn);
             log_buffer_.push_back(std::move(end_checkpoint_log));
         }
         Flush(end_lsn);
@@ -167,6 +249,7 @@ namespace huadb {
 
     void LogManager::FlushPage(oid_t table_oid, pageid_t page_id, lsn_t page_lsn) {
         Flush(page_lsn);
+        std::unique_lock lock(dpt_mutex_);
         dpt_.erase({table_oid, page_id});
     }
 
@@ -175,31 +258,36 @@ namespace huadb {
         // 依次获取 lsn 的 prev_lsn_，直到 NULL_LSN
         // 根据 lsn 和 flushed_lsn_ 的大小关系，判断日志在 buffer 中还是在磁盘中
         // 若日志在 buffer 中，通过 log_buffer_ 获取日志
-        // 若日志在磁盘中，通过 disk_ 读取日志，count 参数可设置为 MAX_LOG_SIZE
+        // 若日志在磁盘中，通过 disk_ 读取日志，count 参数可设置为 GetMaxLogSize(disk_.GetPageSize())
         // 通过 LogRecord::DeserializeFrom 函数解析日志
         // 调用日志的 Undo 函数
 
-        lsn_t lsn = att_.find(xid)->second;
+        lsn_t lsn;
+        {
+            std::shared_lock lock(log_buffer_mutex_);
+            lsn = att_.find(xid)->second;
+        }
         while (lsn != NULL_LSN) {
-            // log buffer
-            if (lsn > flushed_lsn_) {
-                for (const auto &record: log_buffer_) {
-                    if (record->GetLSN() == lsn) {
-                        lsn = record->GetPrevLSN();
-                        record->Undo(*buffer_pool_, *catalog_, *this, lsn);
+            std::shared_ptr<LogRecord> record;
+            // log buffer，flushed_lsn_ 为 NULL_LSN 时还没有日志刷过盘
+            if (flushed_lsn_ == NULL_LSN || lsn > flushed_lsn_) {
+                std::shared_lock lock(log_buffer_mutex_);
+                for (const auto &buffered_record: log_buffer_) {
+                    if (buffered_record->GetLSN() == lsn) {
+                        record = buffered_record;
                         break;
                     }
                 }
             }
-                // disk
-            else {
-                char *record_data = static_cast<char *>(malloc(MAX_LOG_SIZE * sizeof(char)));
-                disk_.ReadLog(lsn, MAX_LOG_SIZE, record_data);
-                auto record = LogRecord::DeserializeFrom(lsn, record_data);
-                lsn = record->GetPrevLSN();
-                record->Undo(*buffer_pool_, *catalog_, *this, lsn);
-                delete record_data;
+            // disk，日志可能在判断后被后台写进程刷盘，此时也从磁盘读取
+            if (record == nullptr) {
+                auto max_log_size = GetMaxLogSize(disk_.GetPageSize());
+                auto record_data = std::make_unique<char[]>(max_log_size);
+                disk_.ReadLog(lsn, max_log_size, record_data.get());
+                record = LogRecord::DeserializeFrom(lsn, record_data.get());
             }
+            lsn = record->GetPrevLSN();
+            record->Undo(*buffer_pool_, *catalog_, *this, lsn);
         }
     }
 
@@ -214,42 +302,55 @@ namespace huadb {
     uint32_t LogManager::GetRedoCount() const { return redo_count_; }
 
     void LogManager::Flush(lsn_t lsn) {
-        size_t max_log_size = 0;
-        lsn_t max_lsn = NULL_LSN;
+        // 如果 lsn 为 NULL_LSN，表示 log_buffer_ 中所有日志都需要刷盘
+        // 如果 flushed_lsn_ 为 NULL_LSN，表示还没有日志刷过盘
+        if (lsn != NULL_LSN && flushed_lsn_ != NULL_LSN && lsn <= flushed_lsn_) {
+            return;
+        }
+        // 写日志与同步在刷盘锁内进行，不阻塞追加日志。log_buffer_ 开头的日志只由持有刷盘锁的线程移除
+        std::unique_lock flush_lock(flush_mutex_);
+        std::vector<std::shared_ptr<LogRecord>> log_records;
         {
-            std::unique_lock lock(log_buffer_mutex_);
-            for (auto iterator = log_buffer_.cbegin(); iterator != log_buffer_.cend();) {
-                const auto &log_record = *iterator;
-                // 如果 lsn 为 NULL_LSN，表示 log_buffer_ 中所有日志都需要刷盘
+            // lsn 的分配与日志的加入在同一把锁内进行，log_buffer_ 按 lsn 有序，刷盘的是其中连续的前缀
+            std::shared_lock lock(log_buffer_mutex_);
+            for (const auto &log_record : log_buffer_) {
                 if (lsn != NULL_LSN && log_record->GetLSN() > lsn) {
-                    iterator++;
-                    continue;
+                    break;
                 }
-                auto log_size = log_record->GetSize();
-                auto log = std::make_unique<char[]>(log_size);
-                log_record->SerializeTo(log.get());
-                disk_.WriteLog(log_record->GetLSN(), log_size, log.get());
-                if (max_lsn == NULL_LSN || log_record->GetLSN() > max_lsn) {
-                    max_lsn = log_record->GetLSN();
-                    max_log_size = log_size;
-                }
-                iterator = log_buffer_.erase(iterator);
+                log_records.push_back(log_record);
             }
         }
-        // 如果 max_lsn 为 NULL_LSN，表示没有日志刷盘
-        // 如果 flushed_lsn_ 为 NULL_LSN，表示还没有日志刷过盘
-        if (max_lsn != NULL_LSN && (flushed_lsn_ == NULL_LSN || max_lsn > flushed_lsn_)) {
-            flushed_lsn_ = max_lsn;
-            lsn_t next_lsn = FIRST_LSN;
-            if (disk_.FileExists(NEXT_LSN_NAME)) {
-                std::ifstream in(NEXT_LSN_NAME);
-                in >> next_lsn;
-            }
-            if (flushed_lsn_ + max_log_size > next_lsn) {
-                std::ofstream out(NEXT_LSN_NAME);
-                out << (flushed_lsn_ + max_log_size);
+        if (log_records.empty()) {
+            return;
+        }
+        // lsn 即日志在日志文件中的偏移，将这些日志序列化到同一块缓冲区中一次写入
+        lsn_t first_lsn = log_records.front()->GetLSN();
+        lsn_t max_lsn = log_records.back()->GetLSN();
+        size_t max_log_size = log_records.back()->GetSize();
+        size_t total_size = max_lsn + max_log_size - first_lsn;
+        auto data = std::make_unique<char[]>(total_size);
+        for (const auto &log_record : log_records) {
+            log_record->SerializeTo(data.get() + (log_record->GetLSN() - first_lsn));
+        }
+        disk_.WriteLog(first_lsn, total_size, data.get());
+        disk_.SyncLog();
+        {
+            // 日志持久化后才从 log_buffer_ 中移除，回滚时总能在 log_buffer_ 或磁盘中找到日志
+            std::unique_lock lock(log_buffer_mutex_);
+            log_buffer_.erase(log_buffer_.begin(), std::next(log_buffer_.begin(), log_records.size()));
+            if (flushed_lsn_ == NULL_LSN || max_lsn > flushed_lsn_) {
+                flushed_lsn_ = max_lsn;
             }
         }
+        lsn_t next_lsn = FIRST_LSN;
+        if (disk_.FileExists(NEXT_LSN_NAME)) {
+            std::ifstream in(NEXT_LSN_NAME);
+            in >> next_lsn;
+        }
+        if (max_lsn + max_log_size > next_lsn) {
+            std::ofstream out(NEXT_LSN_NAME);
+            out << (max_lsn + max_log_size);
+        }
     }
 
     void LogManager::Analyze() {
@@ -277,10 +378,11 @@ namespace huadb {
         lsn_t lsn = checkpoint_lsn;
         // 重做阶段开始位置
         min_rec_lsn_ = checkpoint_lsn;
-        char *record_data = static_cast<char *>(malloc(MAX_LOG_SIZE * sizeof(char)));
+        auto max_log_size = GetMaxLogSize(disk_.GetPageSize());
+        char *record_data = static_cast<char *>(malloc(max_log_size * sizeof(char)));
 
         while (lsn < next_lsn_) {
-            disk_.ReadLog(lsn, MAX_LOG_SIZE, record_data);
+            disk_.ReadLog(lsn, max_log_size, record_data);
             auto record = LogRecord::DeserializeFrom(lsn, record_data);
 
             // 检查点结束记录
@@ -297,13 +399,14 @@ namespace huadb {
         lsn = checkpoint_lsn;
 
         while (lsn < next_lsn_) {
-            disk_.ReadLog(lsn, MAX_LOG_SIZE, record_data);
+            disk_.ReadLog(lsn, max_log_size, record_data);
             auto record = LogRecord::DeserializeFrom(lsn, record_data);
             xid_t xid = record->GetXid();
 
             // 更新活跃事务表
             if (record->GetType() == LogType::INSERT || record->GetType() == LogType::DELETE ||
-                record->GetType() == LogType::NEW_PAGE) {
+                record->GetType() == LogType::NEW_PAGE || record->GetType() == LogType::BULK_INSERT ||
+                record->GetType() == LogType::UPDATE) {
                 att_[xid] = lsn;
             }
             // 事务结束记录
@@ -321,12 +424,19 @@ namespace huadb {
             pageid_t page_id = GetRecordInfo(record).second;
 
             if (record->GetType() == LogType::INSERT || record->GetType() == LogType::DELETE ||
-                record->GetType() == LogType::NEW_PAGE) {
+                record->GetType() == LogType::NEW_PAGE || record->GetType() == LogType::BULK_INSERT ||
+                record->GetType() == LogType::COMPACT_PAGE || record->GetType() == LogType::UPDATE ||
+                record->GetType() == LogType::TRUNCATE) {
                 // 更新脏页表
                 if (dpt_.find({oid, page_id}) == dpt_.end()) {
                     dpt_[{oid, page_id}] = lsn;
                 }
             }
+            // 被截断的页面之前的修改无需重做，之后再次扩展时由 NewPageLog 重新加入脏页表
+            if (record->GetType() == LogType::TRUNCATE) {
+                auto page_count = std::dynamic_pointer_cast<TruncateLog>(record)->GetPageCount();
+                EraseTruncatedPages(oid, page_count);
+            }
 
             lsn += record->GetSize();
         }
@@ -345,17 +455,22 @@ namespace huadb {
             }
         }
 
-        char *record_data = static_cast<char *>(malloc(MAX_LOG_SIZE * sizeof(char)));
+        PrefetchDirtyPages();
+
+        auto max_log_size = GetMaxLogSize(disk_.GetPageSize());
+        char *record_data = static_cast<char *>(malloc(max_log_size * sizeof(char)));
 
         while (lsn < next_lsn_) {
-            disk_.ReadLog(lsn, MAX_LOG_SIZE, record_data);
+            disk_.ReadLog(lsn, max_log_size, record_data);
             auto record = LogRecord::DeserializeFrom(lsn, record_data);
 
             oid_t oid = GetRecordInfo(record).first;
             pageid_t page_id = GetRecordInfo(record).second;
 
             if (record->GetType() == LogType::INSERT || record->GetType() == LogType::DELETE ||
-                record->GetType() == LogType::NEW_PAGE) {
+                record->GetType() == LogType::NEW_PAGE || record->GetType() == LogType::BULK_INSERT ||
+                record->GetType() == LogType::COMPACT_PAGE || record->GetType() == LogType::UPDATE ||
+                record->GetType() == LogType::TRUNCATE) {
                 // 在脏页表
                 if (dpt_.find({oid, page_id}) != dpt_.end()) {
                     lsn_t recLSN = dpt_[{oid, page_id}];
@@ -365,9 +480,13 @@ namespace huadb {
                             record->Redo(*buffer_pool_, *catalog_, *this);
                         } else {
                             oid_t db_oid = catalog_->GetDatabaseOid(oid);
-                            auto current_page = buffer_pool_->GetPage(db_oid, oid, page_id);
-                            TablePage table_page(current_page);
-                            lsn_t pageLSN = table_page.GetPageLSN();
+                            lsn_t pageLSN;
+                            {
+                                auto current_page = buffer_pool_->GetPage(db_oid, oid, page_id);
+                                std::shared_lock latch(current_page->GetLatch());
+                                TablePage table_page(current_page);
+                                pageLSN = table_page.GetPageLSN();
+                            }
 
                             // 页面未在检查点后刷新
                             if (lsn > pageLSN) {
@@ -383,6 +502,30 @@ namespace huadb {
         delete record_data;
     }
 
+    void LogManager::PrefetchDirtyPages() {
+        std::map<oid_t, std::vector<pageid_t>> table_pages;
+        for (const auto &[table_pageid, rec_lsn] : dpt_) {
+            table_pages[table_pageid.table_oid_].push_back(table_pageid.page_id_);
+        }
+        for (auto &[table_oid, page_ids] : table_pages) {
+            std::sort(page_ids.begin(), page_ids.end());
+            try {
+                auto db_oid = catalog_->GetDatabaseOid(table_oid);
+                // 每次至多预读一半的缓存容量，分批处理直到所有页面都已预读，返回 0 表示不支持预读
+                for (size_t offset = 0; offset < page_ids.size();) {
+                    auto consumed = buffer_pool_->PrefetchPages(
+                            db_oid, table_oid, {page_ids.begin() + offset, page_ids.end()});
+                    if (consumed == 0) {
+                        break;
+                    }
+                    offset += consumed;
+                }
+            } catch (DbException &e) {
+                // 预读失败（如表已被删除）不影响重做，重做时按需读取
+            }
+        }
+    }
+
     void LogManager::Undo() {
         // 根据活跃事务表，将所有活跃事务回滚
         // LAB 2 BEGIN
@@ -410,6 +553,26 @@ namespace huadb {
             assert(new_page_record != nullptr);
             page_id = new_page_record->GetPageId();
             oid = new_page_record->GetOid();
+        } else if (record->GetType() == LogType::BULK_INSERT) {
+            auto bulk_insert_record = std::dynamic_pointer_cast<BulkInsertLog>(record);
+            assert(bulk_insert_record != nullptr);
+            page_id = bulk_insert_record->GetPageId();
+            oid = bulk_insert_record->GetOid();
+        } else if (record->GetType() == LogType::COMPACT_PAGE) {
+            auto compact_page_record = std::dynamic_pointer_cast<CompactPageLog>(record);
+            assert(compact_page_record != nullptr);
+            page_id = compact_page_record->GetPageId();
+            oid = compact_page_record->GetOid();
+        } else if (record->GetType() == LogType::UPDATE) {
+            auto update_record = std::dynamic_pointer_cast<UpdateLog>(record);
+            assert(update_record != nullptr);
+            page_id = update_record->GetPageId();
+            oid = update_record->GetOid();
+        } else if (record->GetType() == LogType::TRUNCATE) {
+            auto truncate_record = std::dynamic_pointer_cast<TruncateLog>(record);
+            assert(truncate_record != nullptr);
+            page_id = truncate_record->GetPageId();
+            oid = truncate_record->GetOid();
         } else {}
 
         return std::make_pair(oid, page_id);
@@ -5,6 +5,7 @@
 #include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "catalog/catalog.h"
 #include "common/constants.h"
@@ -39,10 +40,24 @@ namespace huadb {
         AppendInsertLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t slot_id, db_size_t offset, db_size_t size,
                         char *new_record);
 
+        // 页面中从 first_slot_id 开始连续插入的多条记录，records 为页面 [upper, upper + records.size()) 区域的内容
+        lsn_t AppendBulkInsertLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t first_slot_id,
+                                  std::vector<Slot> slots, db_size_t upper, std::vector<char> records);
+
         lsn_t AppendDeleteLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t slot_id);
 
+        // 页面内更新，旧版本位于 old_slot_id，新版本位于 new_slot_id，new_record 为新版本在页面 offset 处的内容
+        lsn_t AppendUpdateLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t old_slot_id, slotid_t new_slot_id,
+                              db_size_t offset, db_size_t size, const char *new_record);
+
         lsn_t AppendNewPageLog(xid_t xid, oid_t oid, pageid_t prev_page_id, pageid_t page_id);
 
+        // 整理页面，不属于任何事务
+        lsn_t AppendCompactPageLog(oid_t oid, pageid_t page_id, std::vector<slotid_t> dead_slots);
+
+        // 截断表文件，只保留前 page_count 个页面，不属于任何事务。被截断的页面从脏页表中移除
+        lsn_t AppendTruncateLog(oid_t oid, pageid_t page_count);
+
         lsn_t AppendBeginLog(xid_t xid);
 
         lsn_t AppendCommitLog(xid_t xid);
@@ -83,6 +98,12 @@ namespace huadb {
         // 重做阶段，恢复未刷盘的脏页
         void Redo();
 
+        // 从脏页表中移除表 oid 中页面号不小于 page_count 的页面，调用时需持有 dpt_mutex_ 或处于恢复阶段
+        void EraseTruncatedPages(oid_t oid, pageid_t page_count);
+
+        // 按表批量预读脏页表中的页面，使重做时的页面读取并发进行
+        void PrefetchDirtyPages();
+
         // 恢复阶段，回滚所有活跃事务
         void Undo();
 
@@ -91,16 +112,20 @@ namespace huadb {
         std::shared_ptr<BufferPool> buffer_pool_;
         std::shared_ptr<Catalog> catalog_;
 
-        std::unordered_map<xid_t, lsn_t> att_;        // 活跃事务表
+        std::unordered_map<xid_t, lsn_t> att_;        // 活跃事务表，由 log_buffer_mutex_ 保护
         std::unordered_map<TablePageid, lsn_t> dpt_;  // 脏页表
+        std::mutex dpt_mutex_;                        // 保护脏页表，刷脏页可能来自后台写进程
 
         // 下一条日志的 lsn
         std::atomic<lsn_t> next_lsn_;
         // 已经刷到磁盘的最大 lsn
-        lsn_t flushed_lsn_;
+        std::atomic<lsn_t> flushed_lsn_;
 
         std::list<std::shared_ptr<LogRecord>> log_buffer_;
+        // 分配 lsn、加入 log_buffer_ 与更新活跃事务表在此锁内一并完成，使 log_buffer_ 按 lsn 有序
         std::shared_mutex log_buffer_mutex_;
+        // 串行化日志刷盘，加锁顺序为 flush_mutex_ -> log_buffer_mutex_
+        std::mutex flush_mutex_;
 
         uint32_t redo_count_ = 0;
     };
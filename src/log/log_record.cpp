@@ -41,6 +41,14 @@ namespace huadb {
                 return BeginCheckpointLog::DeserializeFrom(lsn, data + sizeof(type));
             case LogType::END_CHECKPOINT:
                 return EndCheckpointLog::DeserializeFrom(lsn, data + sizeof(type));
+            case LogType::BULK_INSERT:
+                return BulkInsertLog::DeserializeFrom(lsn, data + sizeof(type));
+            case LogType::COMPACT_PAGE:
+                return CompactPageLog::DeserializeFrom(lsn, data + sizeof(type));
+            case LogType::UPDATE:
+                return UpdateLog::DeserializeFrom(lsn, data + sizeof(type));
+            case LogType::TRUNCATE:
+                return TruncateLog::DeserializeFrom(lsn, data + sizeof(type));
             default:
                 throw DbException("Unknown log type in DeserializeFrom");
         }
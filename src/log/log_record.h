@@ -22,6 +22,10 @@ namespace huadb {
         NEW_PAGE,
         BEGIN_CHECKPOINT,
         END_CHECKPOINT,
+        BULK_INSERT,
+        COMPACT_PAGE,
+        UPDATE,
+        TRUNCATE,
     };
 
     class LogRecord {
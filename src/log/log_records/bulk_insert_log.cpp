@@ -0,0 +1,112 @@
+#include "log/log_records/bulk_insert_log.h"
+
+#include "table/table_page.h"
+
+namespace huadb {
+
+BulkInsertLog::BulkInsertLog(lsn_t lsn, xid_t xid, lsn_t prev_lsn, oid_t oid, pageid_t page_id,
+                             slotid_t first_slot_id, std::vector<Slot> slots, db_size_t upper,
+                             std::vector<char> records)
+    : LogRecord(LogType::BULK_INSERT, lsn, xid, prev_lsn),
+      oid_(oid),
+      page_id_(page_id),
+      first_slot_id_(first_slot_id),
+      slots_(std::move(slots)),
+      upper_(upper),
+      records_(std::move(records)) {
+  size_ += sizeof(oid_) + sizeof(page_id_) + sizeof(first_slot_id_) + sizeof(slotid_t) + sizeof(upper_) +
+           sizeof(db_size_t) + slots_.size() * sizeof(Slot) + records_.size();
+}
+
+size_t BulkInsertLog::SerializeTo(char *data) const {
+  size_t offset = LogRecord::SerializeTo(data);
+  slotid_t slot_count = slots_.size();
+  db_size_t records_size = records_.size();
+  memcpy(data + offset, &oid_, sizeof(oid_));
+  offset += sizeof(oid_);
+  memcpy(data + offset, &page_id_, sizeof(page_id_));
+  offset += sizeof(page_id_);
+  memcpy(data + offset, &first_slot_id_, sizeof(first_slot_id_));
+  offset += sizeof(first_slot_id_);
+  memcpy(data + offset, &slot_count, sizeof(slot_count));
+  offset += sizeof(slot_count);
+  memcpy(data + offset, &upper_, sizeof(upper_));
+  offset += sizeof(upper_);
+  memcpy(data + offset, &records_size, sizeof(records_size));
+  offset += sizeof(records_size);
+  memcpy(data + offset, slots_.data(), slots_.size() * sizeof(Slot));
+  offset += slots_.size() * sizeof(Slot);
+  memcpy(data + offset, records_.data(), records_.size());
+  offset += records_.size();
+  assert(offset == size_);
+  return offset;
+}
+
+std::shared_ptr<BulkInsertLog> BulkInsertLog::DeserializeFrom(lsn_t lsn, const char *data) {
+  xid_t xid;
+  lsn_t prev_lsn;
+  oid_t oid;
+  pageid_t page_id;
+  slotid_t first_slot_id, slot_count;
+  db_size_t upper, records_size;
+  size_t offset = 0;
+  memcpy(&xid, data + offset, sizeof(xid));
+  offset += sizeof(xid);
+  memcpy(&prev_lsn, data + offset, sizeof(prev_lsn));
+  offset += sizeof(prev_lsn);
+  memcpy(&oid, data + offset, sizeof(oid));
+  offset += sizeof(oid);
+  memcpy(&page_id, data + offset, sizeof(page_id));
+  offset += sizeof(page_id);
+  memcpy(&first_slot_id, data + offset, sizeof(first_slot_id));
+  offset += sizeof(first_slot_id);
+  memcpy(&slot_count, data + offset, sizeof(slot_count));
+  offset += sizeof(slot_count);
+  memcpy(&upper, data + offset, sizeof(upper));
+  offset += sizeof(upper);
+  memcpy(&records_size, data + offset, sizeof(records_size));
+  offset += sizeof(records_size);
+  std::vector<Slot> slots(slot_count);
+  memcpy(slots.data(), data + offset, slot_count * sizeof(Slot));
+  offset += slot_count * sizeof(Slot);
+  std::vector<char> records(data + offset, data + offset + records_size);
+  return std::make_shared<BulkInsertLog>(lsn, xid, prev_lsn, oid, page_id, first_slot_id, std::move(slots), upper,
+                                         std::move(records));
+}
+
+void BulkInsertLog::Undo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager, lsn_t undo_next_lsn) {
+  auto db_oid = catalog.GetDatabaseOid(oid_);
+  auto page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+  std::unique_lock latch(page->GetLatch());
+  TablePage table_page(page);
+  for (size_t i = 0; i < slots_.size(); i++) {
+    table_page.DeleteRecord(first_slot_id_ + i, xid_);
+  }
+}
+
+void BulkInsertLog::Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) {
+  // 表已被删除时无需重做
+  if (!catalog.TableExists(oid_)) {
+    return;
+  }
+  auto db_oid = catalog.GetDatabaseOid(oid_);
+  auto page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+  std::unique_lock latch(page->GetLatch());
+  TablePage table_page(page);
+  for (size_t i = 0; i < slots_.size(); i++) {
+    const auto &slot = slots_[i];
+    table_page.RedoInsertRecord(first_slot_id_ + i, records_.data() + (slot.offset_ - upper_), slot.offset_,
+                                slot.size_);
+  }
+}
+
+oid_t BulkInsertLog::GetOid() const { return oid_; }
+
+pageid_t BulkInsertLog::GetPageId() const { return page_id_; }
+
+std::string BulkInsertLog::ToString() const {
+  return fmt::format("BulkInsertLog\t\t[{}\toid: {}\tpage_id: {}\tfirst_slot_id: {}\trecord_count: {}\tupper: {}]",
+                     LogRecord::ToString(), oid_, page_id_, first_slot_id_, slots_.size(), upper_);
+}
+
+}  // namespace huadb
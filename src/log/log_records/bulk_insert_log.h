@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "log/log_record.h"
+
+namespace huadb {
+
+// 一个页面中连续插入的多条记录合并为一条日志
+// 一次批量插入的槽位从 first_slot_id 开始连续分配，记录在页面中占据 [upper, upper + records.size()) 的连续区域，
+// 因此日志只需保存槽位数组和该区域的内容。两者之和不超过页面可用空间，日志长度不超过 GetMaxLogSize
+class BulkInsertLog : public LogRecord {
+ public:
+  BulkInsertLog(lsn_t lsn, xid_t xid, lsn_t prev_lsn, oid_t oid, pageid_t page_id, slotid_t first_slot_id,
+                std::vector<Slot> slots, db_size_t upper, std::vector<char> records);
+
+  size_t SerializeTo(char *data) const override;
+  static std::shared_ptr<BulkInsertLog> DeserializeFrom(lsn_t lsn, const char *data);
+
+  void Undo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager, lsn_t undo_next_lsn) override;
+  void Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) override;
+
+  oid_t GetOid() const;
+  pageid_t GetPageId() const;
+
+  std::string ToString() const override;
+
+ private:
+  oid_t oid_;
+  pageid_t page_id_;
+  slotid_t first_slot_id_;
+  std::vector<Slot> slots_;
+  db_size_t upper_;  // 批量插入后页面的 upper 指针，即 records_ 在页面中的起始位置
+  std::vector<char> records_;
+};
+
+}  // namespace huadb
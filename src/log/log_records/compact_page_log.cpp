@@ -0,0 +1,73 @@
+#include "log/log_records/compact_page_log.h"
+
+#include "table/table_page.h"
+
+namespace huadb {
+
+CompactPageLog::CompactPageLog(lsn_t lsn, oid_t oid, pageid_t page_id, std::vector<slotid_t> dead_slots)
+    : LogRecord(LogType::COMPACT_PAGE, lsn, DDL_XID, NULL_LSN),
+      oid_(oid),
+      page_id_(page_id),
+      dead_slots_(std::move(dead_slots)) {
+  size_ += sizeof(oid_) + sizeof(page_id_) + sizeof(slotid_t) + dead_slots_.size() * sizeof(slotid_t);
+}
+
+size_t CompactPageLog::SerializeTo(char *data) const {
+  size_t offset = LogRecord::SerializeTo(data);
+  slotid_t slot_count = dead_slots_.size();
+  memcpy(data + offset, &oid_, sizeof(oid_));
+  offset += sizeof(oid_);
+  memcpy(data + offset, &page_id_, sizeof(page_id_));
+  offset += sizeof(page_id_);
+  memcpy(data + offset, &slot_count, sizeof(slot_count));
+  offset += sizeof(slot_count);
+  memcpy(data + offset, dead_slots_.data(), dead_slots_.size() * sizeof(slotid_t));
+  offset += dead_slots_.size() * sizeof(slotid_t);
+  assert(offset == size_);
+  return offset;
+}
+
+std::shared_ptr<CompactPageLog> CompactPageLog::DeserializeFrom(lsn_t lsn, const char *data) {
+  xid_t xid;
+  lsn_t prev_lsn;
+  oid_t oid;
+  pageid_t page_id;
+  slotid_t slot_count;
+  size_t offset = 0;
+  memcpy(&xid, data + offset, sizeof(xid));
+  offset += sizeof(xid);
+  memcpy(&prev_lsn, data + offset, sizeof(prev_lsn));
+  offset += sizeof(prev_lsn);
+  memcpy(&oid, data + offset, sizeof(oid));
+  offset += sizeof(oid);
+  memcpy(&page_id, data + offset, sizeof(page_id));
+  offset += sizeof(page_id);
+  memcpy(&slot_count, data + offset, sizeof(slot_count));
+  offset += sizeof(slot_count);
+  std::vector<slotid_t> dead_slots(slot_count);
+  memcpy(dead_slots.data(), data + offset, slot_count * sizeof(slotid_t));
+  return std::make_shared<CompactPageLog>(lsn, oid, page_id, std::move(dead_slots));
+}
+
+void CompactPageLog::Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) {
+  // 表已被删除时无需重做
+  if (!catalog.TableExists(oid_)) {
+    return;
+  }
+  auto db_oid = catalog.GetDatabaseOid(oid_);
+  auto page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+  std::unique_lock latch(page->GetLatch());
+  TablePage table_page(page);
+  table_page.Compact(dead_slots_);
+}
+
+oid_t CompactPageLog::GetOid() const { return oid_; }
+
+pageid_t CompactPageLog::GetPageId() const { return page_id_; }
+
+std::string CompactPageLog::ToString() const {
+  return fmt::format("CompactPageLog\t\t[{}\toid: {}\tpage_id: {}\tdead_slot_count: {}]", LogRecord::ToString(), oid_,
+                     page_id_, dead_slots_.size());
+}
+
+}  // namespace huadb
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+#include "log/log_record.h"
+
+namespace huadb {
+
+// 整理页面：释放对所有事务均不可见的记录并合并空闲空间
+// 整理不属于任何事务，日志不加入事务的日志链，无需撤销。重做时在相同的页面内容上释放相同的槽位，得到相同的页面
+class CompactPageLog : public LogRecord {
+ public:
+  CompactPageLog(lsn_t lsn, oid_t oid, pageid_t page_id, std::vector<slotid_t> dead_slots);
+
+  size_t SerializeTo(char *data) const override;
+  static std::shared_ptr<CompactPageLog> DeserializeFrom(lsn_t lsn, const char *data);
+
+  void Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) override;
+
+  oid_t GetOid() const;
+  pageid_t GetPageId() const;
+
+  std::string ToString() const override;
+
+ private:
+  oid_t oid_;
+  pageid_t page_id_;
+  std::vector<slotid_t> dead_slots_;
+};
+
+}  // namespace huadb
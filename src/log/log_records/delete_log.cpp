@@ -46,6 +46,7 @@ namespace huadb {
         // LAB 2 BEGIN
         auto db_oid = catalog.GetDatabaseOid(oid_);
         auto current_page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+        std::unique_lock latch(current_page->GetLatch());
         TablePage table_page(current_page);
 
         table_page.UndoDeleteRecord(slot_id_);
@@ -61,6 +62,7 @@ namespace huadb {
         // LAB 2 BEGIN
         auto db_oid = catalog.GetDatabaseOid(oid_);
         auto current_page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+        std::unique_lock latch(current_page->GetLatch());
         TablePage table_page(current_page);
 
         table_page.DeleteRecord(slot_id_, xid_);
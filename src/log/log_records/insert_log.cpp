@@ -78,6 +78,7 @@ namespace huadb {
         // LAB 2 BEGIN
         auto db_oid = catalog.GetDatabaseOid(oid_);
         auto current_page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+        std::unique_lock latch(current_page->GetLatch());
         TablePage table_page(current_page);
         table_page.DeleteRecord(slot_id_, xid_);
     }
@@ -91,6 +92,7 @@ namespace huadb {
         // LAB 2 BEGIN
         auto db_oid = catalog.GetDatabaseOid(oid_);
         auto current_page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+        std::unique_lock latch(current_page->GetLatch());
         TablePage table_page(current_page);
 
         table_page.RedoInsertRecord(slot_id_, record_, page_offset_, record_size_);
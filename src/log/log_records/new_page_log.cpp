@@ -41,18 +41,8 @@ namespace huadb {
     }
 
     void NewPageLog::Undo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager, lsn_t undo_next_lsn) {
-        // LAB 2 BEGIN
-        auto db_oid = catalog.GetDatabaseOid(oid_);
-
-        auto current_page = buffer_pool.GetPage(db_oid, oid_, page_id_);
-        TablePage cur_table_page(current_page);
-        auto next_page_id = cur_table_page.GetNextPageId();
-
-        if (prev_page_id_ != NULL_PAGE_ID) {
-            auto prev_page = buffer_pool.GetPage(db_oid, oid_, prev_page_id_);
-            TablePage prev_table_page(prev_page);
-            prev_table_page.SetNextPageId(next_page_id);
-        }
+        // 新页面保留在链表中，其中的记录由插入日志的撤销标记删除
+        // 若将页面从链表中摘除，文件中会留下链表外的页面：之后扩展表时会重复使用该页面号，空闲空间映射和缓存的最后一个页面也会指向链表外的页面
     }
 
     void NewPageLog::Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) {
@@ -65,21 +55,18 @@ namespace huadb {
         // LAB 2 BEGIN
         auto db_oid = catalog.GetDatabaseOid(oid_);
 
-        pageid_t next_page_id = NULL_PAGE_ID;
-
+        // 新页面总是追加在链表末尾且回滚时不会摘除，初始化后下一页面为空
         if (prev_page_id_ != NULL_PAGE_ID) {
             auto prev_page = buffer_pool.GetPage(db_oid, oid_, prev_page_id_);
+            std::unique_lock latch(prev_page->GetLatch());
             TablePage prev_table_page(prev_page);
-
-            next_page_id = prev_table_page.GetNextPageId();
             prev_table_page.SetNextPageId(page_id_);
         }
 
         auto cur_page = buffer_pool.NewPage(db_oid, oid_, page_id_);
+        std::unique_lock latch(cur_page->GetLatch());
         TablePage cur_table_page(cur_page);
         cur_table_page.Init();
-
-        cur_table_page.SetNextPageId(next_page_id);
     }
 
     oid_t NewPageLog::GetOid() const { return oid_; }
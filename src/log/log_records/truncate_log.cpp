@@ -0,0 +1,69 @@
+#include "log/log_records/truncate_log.h"
+
+#include "table/table.h"
+#include "table/table_page.h"
+
+namespace huadb {
+
+TruncateLog::TruncateLog(lsn_t lsn, oid_t oid, pageid_t page_count)
+    : LogRecord(LogType::TRUNCATE, lsn, DDL_XID, NULL_LSN), oid_(oid), page_count_(page_count) {
+  size_ += sizeof(oid_) + sizeof(page_count_);
+}
+
+size_t TruncateLog::SerializeTo(char *data) const {
+  size_t offset = LogRecord::SerializeTo(data);
+  memcpy(data + offset, &oid_, sizeof(oid_));
+  offset += sizeof(oid_);
+  memcpy(data + offset, &page_count_, sizeof(page_count_));
+  offset += sizeof(page_count_);
+  assert(offset == size_);
+  return offset;
+}
+
+std::shared_ptr<TruncateLog> TruncateLog::DeserializeFrom(lsn_t lsn, const char *data) {
+  xid_t xid;
+  lsn_t prev_lsn;
+  oid_t oid;
+  pageid_t page_count;
+  size_t offset = 0;
+  memcpy(&xid, data + offset, sizeof(xid));
+  offset += sizeof(xid);
+  memcpy(&prev_lsn, data + offset, sizeof(prev_lsn));
+  offset += sizeof(prev_lsn);
+  memcpy(&oid, data + offset, sizeof(oid));
+  offset += sizeof(oid);
+  memcpy(&page_count, data + offset, sizeof(page_count));
+  return std::make_shared<TruncateLog>(lsn, oid, page_count);
+}
+
+void TruncateLog::Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) {
+  // 表已被删除时无需重做
+  if (!catalog.TableExists(oid_)) {
+    return;
+  }
+  auto db_oid = catalog.GetDatabaseOid(oid_);
+  buffer_pool.TruncateFile(db_oid, oid_, page_count_);
+  {
+    auto page = buffer_pool.GetPage(db_oid, oid_, GetPageId());
+    std::unique_lock latch(page->GetLatch());
+    TablePage table_page(page);
+    table_page.SetNextPageId(NULL_PAGE_ID);
+  }
+  // 重做前已加载的表按截断前的文件大小初始化，需同步其内存中的页面信息。TOAST 关系的表在首次使用时才加载，无需处理
+  try {
+    catalog.GetTable(oid_)->ForgetTruncatedPages(page_count_);
+  } catch (DbException &e) {
+  }
+}
+
+oid_t TruncateLog::GetOid() const { return oid_; }
+
+pageid_t TruncateLog::GetPageId() const { return page_count_ - 1; }
+
+pageid_t TruncateLog::GetPageCount() const { return page_count_; }
+
+std::string TruncateLog::ToString() const {
+  return fmt::format("TruncateLog\t\t[{}\toid: {}\tpage_count: {}]", LogRecord::ToString(), oid_, page_count_);
+}
+
+}  // namespace huadb
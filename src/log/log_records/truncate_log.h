@@ -0,0 +1,31 @@
+#pragma once
+
+#include "log/log_record.h"
+
+namespace huadb {
+
+// 截断表文件：VACUUM 释放表末尾连续的空页面，表只保留前 page_count 个页面，最后一个页面的下一页面置空
+// 截断不属于任何事务，日志不加入事务的日志链，无需撤销。日志记在保留的最后一个页面上，
+// 截断完成后该页面直接写回磁盘，其页面 LSN 不小于本日志时说明文件已截断
+class TruncateLog : public LogRecord {
+ public:
+  TruncateLog(lsn_t lsn, oid_t oid, pageid_t page_count);
+
+  size_t SerializeTo(char *data) const override;
+  static std::shared_ptr<TruncateLog> DeserializeFrom(lsn_t lsn, const char *data);
+
+  void Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) override;
+
+  oid_t GetOid() const;
+  // 保留的最后一个页面
+  pageid_t GetPageId() const;
+  pageid_t GetPageCount() const;
+
+  std::string ToString() const override;
+
+ private:
+  oid_t oid_;
+  pageid_t page_count_;
+};
+
+}  // namespace huadb
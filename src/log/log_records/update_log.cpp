@@ -0,0 +1,103 @@
+#include "log/log_records/update_log.h"
+
+#include "table/table_page.h"
+
+namespace huadb {
+
+UpdateLog::UpdateLog(lsn_t lsn, xid_t xid, lsn_t prev_lsn, oid_t oid, pageid_t page_id, slotid_t old_slot_id,
+                     slotid_t new_slot_id, db_size_t page_offset, std::vector<char> record)
+    : LogRecord(LogType::UPDATE, lsn, xid, prev_lsn),
+      oid_(oid),
+      page_id_(page_id),
+      old_slot_id_(old_slot_id),
+      new_slot_id_(new_slot_id),
+      page_offset_(page_offset),
+      record_(std::move(record)) {
+  size_ += sizeof(oid_) + sizeof(page_id_) + sizeof(old_slot_id_) + sizeof(new_slot_id_) + sizeof(page_offset_) +
+           sizeof(db_size_t) + record_.size();
+}
+
+size_t UpdateLog::SerializeTo(char *data) const {
+  size_t offset = LogRecord::SerializeTo(data);
+  db_size_t record_size = record_.size();
+  memcpy(data + offset, &oid_, sizeof(oid_));
+  offset += sizeof(oid_);
+  memcpy(data + offset, &page_id_, sizeof(page_id_));
+  offset += sizeof(page_id_);
+  memcpy(data + offset, &old_slot_id_, sizeof(old_slot_id_));
+  offset += sizeof(old_slot_id_);
+  memcpy(data + offset, &new_slot_id_, sizeof(new_slot_id_));
+  offset += sizeof(new_slot_id_);
+  memcpy(data + offset, &page_offset_, sizeof(page_offset_));
+  offset += sizeof(page_offset_);
+  memcpy(data + offset, &record_size, sizeof(record_size));
+  offset += sizeof(record_size);
+  memcpy(data + offset, record_.data(), record_.size());
+  offset += record_.size();
+  assert(offset == size_);
+  return offset;
+}
+
+std::shared_ptr<UpdateLog> UpdateLog::DeserializeFrom(lsn_t lsn, const char *data) {
+  xid_t xid;
+  lsn_t prev_lsn;
+  oid_t oid;
+  pageid_t page_id;
+  slotid_t old_slot_id, new_slot_id;
+  db_size_t page_offset, record_size;
+  size_t offset = 0;
+  memcpy(&xid, data + offset, sizeof(xid));
+  offset += sizeof(xid);
+  memcpy(&prev_lsn, data + offset, sizeof(prev_lsn));
+  offset += sizeof(prev_lsn);
+  memcpy(&oid, data + offset, sizeof(oid));
+  offset += sizeof(oid);
+  memcpy(&page_id, data + offset, sizeof(page_id));
+  offset += sizeof(page_id);
+  memcpy(&old_slot_id, data + offset, sizeof(old_slot_id));
+  offset += sizeof(old_slot_id);
+  memcpy(&new_slot_id, data + offset, sizeof(new_slot_id));
+  offset += sizeof(new_slot_id);
+  memcpy(&page_offset, data + offset, sizeof(page_offset));
+  offset += sizeof(page_offset);
+  memcpy(&record_size, data + offset, sizeof(record_size));
+  offset += sizeof(record_size);
+  std::vector<char> record(data + offset, data + offset + record_size);
+  return std::make_shared<UpdateLog>(lsn, xid, prev_lsn, oid, page_id, old_slot_id, new_slot_id, page_offset,
+                                     std::move(record));
+}
+
+void UpdateLog::Undo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager, lsn_t undo_next_lsn) {
+  // 与 InsertLog、DeleteLog 的回滚相同：删除新版本，恢复旧版本
+  auto db_oid = catalog.GetDatabaseOid(oid_);
+  auto page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+  std::unique_lock latch(page->GetLatch());
+  TablePage table_page(page);
+  table_page.DeleteRecord(new_slot_id_, xid_);
+  table_page.UndoDeleteRecord(old_slot_id_);
+}
+
+void UpdateLog::Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) {
+  // 表已被删除时无需重做
+  if (!catalog.TableExists(oid_)) {
+    return;
+  }
+  auto db_oid = catalog.GetDatabaseOid(oid_);
+  auto page = buffer_pool.GetPage(db_oid, oid_, page_id_);
+  std::unique_lock latch(page->GetLatch());
+  TablePage table_page(page);
+  table_page.DeleteRecord(old_slot_id_, xid_);
+  table_page.RedoInsertRecord(new_slot_id_, record_.data(), page_offset_, record_.size());
+}
+
+oid_t UpdateLog::GetOid() const { return oid_; }
+
+pageid_t UpdateLog::GetPageId() const { return page_id_; }
+
+std::string UpdateLog::ToString() const {
+  return fmt::format("UpdateLog\t\t[{}\toid: {}\tpage_id: {}\told_slot_id: {}\tnew_slot_id: {}\tpage_offset: {}\t"
+                     "record_size: {}]",
+                     LogRecord::ToString(), oid_, page_id_, old_slot_id_, new_slot_id_, page_offset_, record_.size());
+}
+
+}  // namespace huadb
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include "log/log_record.h"
+
+namespace huadb {
+
+// 页面内更新：旧版本标记删除，新版本插入同一页面，一条日志代替 DeleteLog 与 InsertLog
+class UpdateLog : public LogRecord {
+ public:
+  UpdateLog(lsn_t lsn, xid_t xid, lsn_t prev_lsn, oid_t oid, pageid_t page_id, slotid_t old_slot_id,
+            slotid_t new_slot_id, db_size_t page_offset, std::vector<char> record);
+
+  size_t SerializeTo(char *data) const override;
+  static std::shared_ptr<UpdateLog> DeserializeFrom(lsn_t lsn, const char *data);
+
+  void Undo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager, lsn_t undo_next_lsn) override;
+  void Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager) override;
+
+  oid_t GetOid() const;
+  pageid_t GetPageId() const;
+
+  std::string ToString() const override;
+
+ private:
+  oid_t oid_;
+  pageid_t page_id_;
+  slotid_t old_slot_id_;
+  slotid_t new_slot_id_;
+  db_size_t page_offset_;  // 新版本在页面中的位置
+  std::vector<char> record_;
+};
+
+}  // namespace huadb
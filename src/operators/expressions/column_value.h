@@ -16,6 +16,8 @@ namespace huadb {
 
         Value Evaluate(std::shared_ptr<const Record> record) override { return record->GetValue(col_idx_); }
 
+        Value EvaluateTuple(const TupleView &tuple) override { return tuple.GetValue(col_idx_); }
+
         Value EvaluateJoin(std::shared_ptr<const Record> left, std::shared_ptr<const Record> right) override {
             if (is_left_) {
                 return left->GetValue(col_idx_);
@@ -28,6 +30,9 @@ namespace huadb {
 
         size_t GetColumnIndex() const { return col_idx_; }
 
+        // 连接条件中是否引用左侧子节点的列
+        bool IsLeft() const { return is_left_; }
+
     private:
         size_t col_idx_;
         bool is_left_;
@@ -45,6 +45,12 @@ namespace huadb {
             return Compute(lhs, rhs);
         }
 
+        Value EvaluateTuple(const TupleView &tuple) override {
+            Value lhs = children_[0]->EvaluateTuple(tuple);
+            Value rhs = children_[1]->EvaluateTuple(tuple);
+            return Compute(lhs, rhs);
+        }
+
         std::string ToString() const override { return fmt::format("{} {} {}", children_[0], type_, children_[1]); }
 
         ComparisonType GetComparisonType() { return type_; }
@@ -89,7 +95,7 @@ namespace huadb {
                             break;
                         case Type::CHAR:
                         case Type::VARCHAR:
-                            in_list = lhs.GetValue<std::string>() == value.GetValue<std::string>();
+                            in_list = lhs.GetValue<std::string_view>() == value.GetValue<std::string_view>();
                             break;
                         default:
                             throw DbException("Type unsupported for comparison operation (in)");
@@ -147,7 +153,7 @@ namespace huadb {
                         }
                     case Type::CHAR:
                     case Type::VARCHAR:
-                        return Value(DoOperation(lhs.GetValue<std::string>(), rhs.GetValue<std::string>()));
+                        return Value(DoOperation(lhs.GetValue<std::string_view>(), rhs.GetValue<std::string_view>()));
                     default:
                         throw DbException("Type unsupported for comparison operation");
                 }
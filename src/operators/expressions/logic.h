@@ -44,6 +44,16 @@ namespace huadb {
             }
         }
 
+        Value EvaluateTuple(const TupleView &tuple) override {
+            if (logic_type_ == LogicType::NOT) {
+                return children_[0]->EvaluateTuple(tuple).Not();
+            } else {
+                Value lhs = children_[0]->EvaluateTuple(tuple);
+                Value rhs = children_[1]->EvaluateTuple(tuple);
+                return Compute(lhs, rhs);
+            }
+        }
+
         std::string ToString() const override {
             if (logic_type_ == LogicType::NOT) {
                 return fmt::format("{} {}", logic_type_, children_[0]);
@@ -552,9 +552,16 @@ std::shared_ptr<Operator> Planner::PlanJoin(const JoinRef &ref) {
           expr->children_[1]->GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
         auto left_key = std::dynamic_pointer_cast<ColumnValue>(expr->children_[0]);
         auto right_key = std::dynamic_pointer_cast<ColumnValue>(expr->children_[1]);
-        auto column_list = GetJoinColumnList(*left, *right);
-        return std::make_shared<HashJoinOperator>(std::move(column_list), std::move(left), std::move(right),
-                                                  std::move(left_key), std::move(right_key), ref.join_type_);
+        // 条件写作 right.col = left.col 时交换，使 left_key 对应左侧子节点
+        if (!left_key->IsLeft() && right_key->IsLeft()) {
+          std::swap(left_key, right_key);
+        }
+        // 两列来自同一侧时不是等值连接，使用嵌套循环连接
+        if (left_key->IsLeft() && !right_key->IsLeft()) {
+          auto column_list = GetJoinColumnList(*left, *right);
+          return std::make_shared<HashJoinOperator>(std::move(column_list), std::move(left), std::move(right),
+                                                    std::move(left_key), std::move(right_key), ref.join_type_);
+        }
       }
     }
   }
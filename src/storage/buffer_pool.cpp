@@ -1,101 +1,575 @@
 #include "storage/buffer_pool.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "common/constants.h"
 #include "common/exceptions.h"
 #include "log/log_manager.h"
+#include "storage/clock_buffer_strategy.h"
+#include "storage/lru_buffer_strategy.h"
+#include "storage/lru_k_buffer_strategy.h"
+#include "storage/two_queue_buffer_strategy.h"
 #include "table/table_page.h"
 
 namespace huadb {
 
-    BufferPool::BufferPool(Disk &disk, LogManager &log_manager) : disk_(disk), log_manager_(log_manager) {
-        buffers_.reserve(BUFFER_SIZE);
-        hashmap_.reserve(BUFFER_SIZE);
-        buffer_strategy_ = std::make_unique<LRUBufferStrategy>();
+    BufferPool::BufferPool(Disk &disk, LogManager &log_manager, size_t buffer_size, size_t systable_buffer_size,
+                           BufferStrategyType buffer_strategy_type)
+            : disk_(disk), log_manager_(log_manager), buffer_strategy_type_(buffer_strategy_type) {
+        if (buffer_size == 0 || systable_buffer_size == 0) {
+            throw DbException("Buffer pool size must be positive");
+        }
+        buffers_.buffer_size_ = buffer_size;
+        systable_buffers_.buffer_size_ = systable_buffer_size;
+        for (auto *pool : {&buffers_, &systable_buffers_}) {
+            pool->buffers_.resize(pool->buffer_size_);
+            pool->buffer_strategy_ = CreateBufferStrategy(pool->buffer_size_);
+        }
     }
 
-    std::shared_ptr<Page> BufferPool::GetPage(oid_t db_oid, oid_t table_oid, pageid_t page_id) {
-        auto &buffers = (db_oid == SYSTEM_DATABASE_OID) ? systable_buffers_ : buffers_;
-        auto &hashmap = (db_oid == SYSTEM_DATABASE_OID) ? systable_hashmap_ : hashmap_;
-        auto entry = hashmap.find({table_oid, page_id});
-        if (entry == hashmap.end()) {
-            auto page = std::make_shared<Page>();
-            disk_.ReadPage(Disk::GetFilePath(db_oid, table_oid), page_id, page->GetData());
-            AddToBuffer(db_oid, table_oid, page_id, page);
+    BufferPool::~BufferPool() { StopBackgroundWriter(); }
+
+    BufferAccessStrategy::BufferAccessStrategy(size_t ring_size) : ring_(ring_size) {}
+
+    size_t BufferAccessStrategy::GetRingSize() const { return ring_.size(); }
+
+    std::shared_ptr<Page> BufferPool::GetPage(oid_t db_oid, oid_t table_oid, pageid_t page_id,
+                                              BufferAccessStrategy *strategy) {
+        auto &pool = GetFramePool(db_oid);
+        size_t frame_id;
+        if (auto page = LookUp(pool, {table_oid, page_id}, frame_id)) {
+            // 命中时不等待替换策略的锁，锁被占用时放弃本次访问记录
+            std::unique_lock lock(pool.latch_, std::try_to_lock);
+            if (lock.owns_lock() && frame_id < pool.buffer_size_) {
+                pool.buffer_strategy_->Access(frame_id);
+            }
             return page;
         }
-        else {
-            if (db_oid != SYSTEM_DATABASE_OID) {
-                buffer_strategy_->Access(entry->second);
-            }
-            return buffers[entry->second].page_;
+        std::unique_lock lock(pool.latch_);
+        // 等待锁期间页面可能已被其他线程读入
+        if (auto page = LookUp(pool, {table_oid, page_id}, frame_id)) {
+            pool.buffer_strategy_->Access(frame_id);
+            return page;
         }
+        auto page = std::make_shared<Page>(disk_.GetPageSize());
+        disk_.ReadPage(db_oid, table_oid, page_id, page->GetData());
+        return AddToBuffer(pool, db_oid, table_oid, page_id, std::move(page), strategy);
     }
 
     std::shared_ptr<Page> BufferPool::NewPage(oid_t db_oid, oid_t table_oid, pageid_t page_id) {
-        auto page = std::make_shared<Page>();
-        AddToBuffer(db_oid, table_oid, page_id, page);
-        return page;
+        auto &pool = GetFramePool(db_oid);
+        std::unique_lock lock(pool.latch_);
+        size_t frame_id;
+        if (auto page = LookUp(pool, {table_oid, page_id}, frame_id)) {
+            // 页面已在缓存中（如重做 NewPageLog），复用帧中原有的页面对象，使其他线程持有的引用仍指向缓存中的页面
+            // 该页面可能正被加锁，释放 pool 锁后再等待页面锁
+            pool.buffer_strategy_->Access(frame_id);
+            lock.unlock();
+            std::unique_lock latch(page->GetLatch());
+            std::memset(page->GetData(), 0, disk_.GetPageSize());
+            return page;
+        }
+        return AddToBuffer(pool, db_oid, table_oid, page_id, std::make_shared<Page>(disk_.GetPageSize()));
     }
 
-    void BufferPool::Flush(bool regular_only) {
-        for (size_t i = 0; i < buffers_.size(); i++) {
-            FlushPage(i);
+    size_t BufferPool::PrefetchPages(oid_t db_oid, oid_t table_oid, const std::vector<pageid_t> &page_ids,
+                                     BufferAccessStrategy *strategy) {
+        if (disk_.GetIOMethod() == IOMethod::SYNC) {
+            return 0;
+        }
+        auto &pool = GetFramePool(db_oid);
+        std::unique_lock lock(pool.latch_);
+        // 预读过多会挤出正在使用的页面
+        size_t max_pages = std::max<size_t>((strategy != nullptr ? strategy->GetRingSize() : pool.buffer_size_) / 2, 1);
+        std::vector<std::shared_ptr<Page>> pages;
+        std::vector<PageIO> requests;
+        size_t consumed = 0;
+        for (; consumed < page_ids.size() && requests.size() < max_pages; consumed++) {
+            auto page_id = page_ids[consumed];
+            size_t frame_id;
+            if (LookUp(pool, {table_oid, page_id}, frame_id) != nullptr) {
+                continue;
+            }
+            pages.push_back(std::make_shared<Page>(disk_.GetPageSize()));
+            requests.push_back({db_oid, table_oid, page_id, pages.back()->GetData()});
+        }
+        disk_.ReadPages(requests);
+        // 转移 pages 中的引用，加入后的页面不处于 pin 状态
+        try {
+            for (size_t i = 0; i < requests.size(); i++) {
+                if (requests[i].ok_) {
+                    AddToBuffer(pool, db_oid, table_oid, requests[i].page_id_, std::move(pages[i]), strategy);
+                }
+            }
+        } catch (DbException &e) {
+            // 缓存中的页面均被 pin 时放弃剩余的预读页面，之后按需读取
+        }
+        return consumed;
+    }
+
+    std::unique_ptr<BufferAccessStrategy> BufferPool::CreateScanStrategy(oid_t db_oid, oid_t table_oid) {
+        size_t ring_size = scan_ring_size_;
+        auto &pool = GetFramePool(db_oid);
+        if (ring_size == 0 || disk_.GetPageCount(db_oid, table_oid) <= pool.buffer_size_ / 4) {
+            return nullptr;
+        }
+        // 环不超过缓存容量的 1/4，为其他页面保留空间
+        return std::make_unique<BufferAccessStrategy>(std::clamp<size_t>(pool.buffer_size_ / 4, 1, ring_size));
+    }
+
+    size_t BufferPool::GetScanRingSize() const { return scan_ring_size_; }
+
+    void BufferPool::SetScanRingSize(size_t scan_ring_size) { scan_ring_size_ = scan_ring_size; }
+
+    size_t BufferPool::GetReadAheadPages() const { return read_ahead_pages_; }
+
+    void BufferPool::SetReadAheadPages(size_t read_ahead_pages) { read_ahead_pages_ = read_ahead_pages; }
+
+    void BufferPool::TruncateFile(oid_t db_oid, oid_t table_oid, pageid_t page_count) {
+        auto &pool = GetFramePool(db_oid);
+        std::vector<std::shared_ptr<Page>> truncated_pages;
+        {
+            // 前台刷盘在 pool 锁内完成；清除脏标记后后台写进程也不会再收集这些页面
+            std::unique_lock lock(pool.latch_);
+            for (size_t i = 0; i < pool.used_frames_; i++) {
+                const auto &entry = pool.buffers_[i];
+                if (entry.page_ == nullptr || entry.table_oid_ != table_oid || entry.page_id_ < page_count) {
+                    continue;
+                }
+                entry.page_->ClearDirty();
+                truncated_pages.push_back(entry.page_);
+            }
         }
-        buffers_.clear();
-        if (!regular_only) {
-            for (size_t i = 0; i < systable_buffers_.size(); i++) {
-                FlushSysTablePage(i);
+        // 在 pool 锁外等待后台写进程正在进行的写回完成，避免截断后被写回的旧页面重新扩展文件
+        for (const auto &page : truncated_pages) {
+            page->WaitForWriteback();
+        }
+        truncated_pages.clear();
+        disk_.TruncateFile(db_oid, table_oid, page_count);
+        // 被截断页面的帧从页表和替换策略中移除，否则之后读取这些页面号时会得到帧中残留的旧内容
+        std::unique_lock lock(pool.latch_);
+        RemoveFrames(pool, [&](const BufferPoolEntry &entry) {
+            return entry.table_oid_ == table_oid && entry.page_id_ >= page_count;
+        });
+    }
+
+    void BufferPool::Flush(bool regular_only) {
+        for (auto *pool : {&buffers_, &systable_buffers_}) {
+            if (regular_only && pool == &systable_buffers_) {
+                continue;
             }
-            systable_buffers_.clear();
+            FlushBuffers(*pool);
+            std::unique_lock lock(pool->latch_);
+            ClearBuffers(*pool, pool->buffer_size_, true);
         }
+        disk_.SyncPages();
     }
 
     void BufferPool::Clear() {
-        buffers_.clear();
-        hashmap_.clear();
-        systable_buffers_.clear();
-        systable_hashmap_.clear();
+        for (auto *pool : {&buffers_, &systable_buffers_}) {
+            std::unique_lock lock(pool->latch_);
+            ClearBuffers(*pool, pool->buffer_size_, false);
+        }
     }
 
-    void BufferPool::AddToBuffer(oid_t db_oid, oid_t table_oid, pageid_t page_id, std::shared_ptr<Page> page) {
-        if (db_oid == SYSTEM_DATABASE_OID) {
-            systable_hashmap_[{table_oid, page_id}] = systable_buffers_.size();
-            systable_buffers_.push_back({db_oid, table_oid, page_id, page});
-        } else {
-            if (buffers_.size() == BUFFER_SIZE) {
-                size_t victim = buffer_strategy_->Evict();
-                FlushPage(victim);
-                buffer_strategy_->Access(victim);
-                buffers_[victim] = {db_oid, table_oid, page_id, page};
-                hashmap_[{table_oid, page_id}] = victim;
+    void BufferPool::CloseFile(oid_t db_oid, oid_t table_oid) { disk_.CloseFile(db_oid, table_oid); }
+
+    size_t BufferPool::GetPageSize() const { return disk_.GetPageSize(); }
+
+    size_t BufferPool::GetBufferSize() const { return buffers_.buffer_size_; }
+
+    void BufferPool::SetBufferSize(size_t buffer_size) { ResizeFramePool(buffers_, buffer_size); }
+
+    size_t BufferPool::GetSysTableBufferSize() const { return systable_buffers_.buffer_size_; }
+
+    void BufferPool::SetSysTableBufferSize(size_t buffer_size) { ResizeFramePool(systable_buffers_, buffer_size); }
+
+    void BufferPool::SetBufferStrategy(BufferStrategyType buffer_strategy_type) {
+        std::scoped_lock lock(buffers_.latch_, systable_buffers_.latch_);
+        if (buffer_strategy_type == buffer_strategy_type_) {
+            return;
+        }
+        buffer_strategy_type_ = buffer_strategy_type;
+        for (auto *pool : {&buffers_, &systable_buffers_}) {
+            pool->buffer_strategy_ = CreateBufferStrategy(pool->buffer_size_);
+            for (size_t i = 0; i < pool->used_frames_; i++) {
+                pool->buffer_strategy_->Access(i);
+            }
+        }
+    }
+
+    void BufferPool::StartBackgroundWriter(size_t delay_ms, size_t max_pages) {
+        StopBackgroundWriter();
+        std::unique_lock lock(bgwriter_mutex_);
+        bgwriter_stop_ = false;
+        bgwriter_start_time_ = std::chrono::steady_clock::now();
+        bgwriter_thread_ = std::thread(&BufferPool::BackgroundWriterLoop, this, delay_ms, max_pages);
+    }
+
+    void BufferPool::StopBackgroundWriter() {
+        std::unique_lock lock(bgwriter_mutex_);
+        if (!bgwriter_thread_.joinable()) {
+            return;
+        }
+        bgwriter_stop_ = true;
+        lock.unlock();
+        bgwriter_cv_.notify_all();
+        bgwriter_thread_.join();
+        lock.lock();
+        bgwriter_run_time_ += std::chrono::steady_clock::now() - bgwriter_start_time_;
+    }
+
+    BackgroundWriterStats BufferPool::GetBackgroundWriterStats() {
+        std::unique_lock lock(bgwriter_mutex_);
+        bool running = bgwriter_thread_.joinable();
+        auto run_time = bgwriter_run_time_;
+        if (running) {
+            run_time += std::chrono::steady_clock::now() - bgwriter_start_time_;
+        }
+        double seconds = std::chrono::duration<double>(run_time).count();
+        uint64_t pages_written = bgwriter_pages_written_;
+        return {running, bgwriter_rounds_, pages_written, backend_pages_written_,
+                seconds > 0 ? pages_written / seconds : 0};
+    }
+
+    BufferPool::FramePool &BufferPool::GetFramePool(oid_t db_oid) {
+        return db_oid == SYSTEM_DATABASE_OID ? systable_buffers_ : buffers_;
+    }
+
+    BufferPool::PageTablePartition &BufferPool::GetPartition(FramePool &pool, const TablePageid &table_pageid) {
+        return pool.page_table_[std::hash<TablePageid>()(table_pageid) % PAGE_TABLE_PARTITIONS];
+    }
+
+    std::shared_ptr<Page> BufferPool::LookUp(FramePool &pool, const TablePageid &table_pageid, size_t &frame_id) {
+        auto &partition = GetPartition(pool, table_pageid);
+        std::shared_lock lock(partition.latch_);
+        auto entry = partition.map_.find(table_pageid);
+        if (entry == partition.map_.end()) {
+            return nullptr;
+        }
+        frame_id = entry->second;
+        // 在分区锁内复制 shared_ptr，保证淘汰线程能看到该 pin
+        return pool.buffers_[frame_id].page_;
+    }
+
+    std::unique_ptr<BufferStrategy> BufferPool::CreateBufferStrategy(size_t buffer_size) const {
+        switch (buffer_strategy_type_) {
+            case BufferStrategyType::LRU:
+                return std::make_unique<LRUBufferStrategy>(buffer_size);
+            case BufferStrategyType::CLOCK:
+                return std::make_unique<ClockBufferStrategy>(buffer_size);
+            case BufferStrategyType::LRU_K:
+                return std::make_unique<LRUKBufferStrategy>(buffer_size);
+            case BufferStrategyType::TWO_QUEUE:
+                return std::make_unique<TwoQueueBufferStrategy>(buffer_size);
+            default:
+                throw DbException("Unknown buffer strategy type");
+        }
+    }
+
+    void BufferPool::ResizeFramePool(FramePool &pool, size_t buffer_size) {
+        if (buffer_size == 0) {
+            throw DbException("Buffer pool size must be positive");
+        }
+        {
+            std::unique_lock lock(pool.latch_);
+            if (buffer_size == pool.buffer_size_) {
+                return;
+            }
+        }
+        // 帧号与容量相关，先刷出所有页面再重建替换策略
+        FlushBuffers(pool);
+        std::unique_lock lock(pool.latch_);
+        if (buffer_size != pool.buffer_size_) {
+            ClearBuffers(pool, buffer_size, true);
+        }
+    }
+
+    std::shared_ptr<Page> BufferPool::AddToBuffer(FramePool &pool, oid_t db_oid, oid_t table_oid, pageid_t page_id,
+                                                  std::shared_ptr<Page> page, BufferAccessStrategy *strategy) {
+        auto &partition = GetPartition(pool, {table_oid, page_id});
+        auto frame_id = strategy != nullptr ? AllocateRingFrame(pool, *strategy, {table_oid, page_id})
+                                            : AllocateFrame(pool);
+        // 帧尚未登记到页表中，其他线程无法访问，可以直接写入
+        pool.buffers_[frame_id] = {db_oid, table_oid, page_id, page};
+        pool.buffer_strategy_->Access(frame_id);
+        std::unique_lock lock(partition.latch_);
+        partition.map_[{table_oid, page_id}] = frame_id;
+        return page;
+    }
+
+    size_t BufferPool::AllocateFrame(FramePool &pool) {
+        if (pool.used_frames_ < pool.buffer_size_) {
+            return pool.used_frames_++;
+        }
+        std::vector<size_t> pinned_frames;
+        for (size_t i = 0; i < pool.buffer_size_; i++) {
+            auto victim = pool.buffer_strategy_->Evict();
+            auto &entry = pool.buffers_[victim];
+            auto &partition = GetPartition(pool, {entry.table_oid_, entry.page_id_});
+            std::unique_lock lock(partition.latch_);
+            // 后台写进程在写回期间持有的引用不算 pin，写回不需要 pool 锁，等待其完成即可
+            entry.page_->WaitForWriteback();
+            // buffer pool 之外仍有引用的页面处于 pin 状态，不能淘汰
+            if (entry.page_.use_count() > 1) {
+                pinned_frames.push_back(victim);
+                continue;
+            }
+            partition.map_.erase({entry.table_oid_, entry.page_id_});
+            lock.unlock();
+            if (FlushPage(entry)) {
+                backend_pages_written_++;
+            }
+            for (auto frame_id : pinned_frames) {
+                pool.buffer_strategy_->Access(frame_id);
+            }
+            return victim;
+        }
+        for (auto frame_id : pinned_frames) {
+            pool.buffer_strategy_->Access(frame_id);
+        }
+        throw DbException("All pages in buffer pool are pinned");
+    }
+
+    size_t BufferPool::AllocateRingFrame(FramePool &pool, BufferAccessStrategy &strategy,
+                                         const TablePageid &table_pageid) {
+        auto &slot = strategy.ring_[strategy.current_];
+        strategy.current_ = (strategy.current_ + 1) % strategy.ring_.size();
+        if (slot.frame_id_ != NULL_FRAME_ID && slot.frame_id_ < pool.used_frames_) {
+            auto &entry = pool.buffers_[slot.frame_id_];
+            if (entry.page_ != nullptr && TablePageid{entry.table_oid_, entry.page_id_} == slot.table_pageid_) {
+                auto &partition = GetPartition(pool, slot.table_pageid_);
+                std::unique_lock lock(partition.latch_);
+                entry.page_->WaitForWriteback();
+                if (entry.page_.use_count() == 1) {
+                    partition.map_.erase(slot.table_pageid_);
+                    lock.unlock();
+                    FlushPage(entry);
+                    slot.table_pageid_ = table_pageid;
+                    return slot.frame_id_;
+                }
+            }
+        }
+        // 槽位为空、帧已被淘汰复用或页面被 pin，从缓存中另行分配
+        slot.frame_id_ = AllocateFrame(pool);
+        slot.table_pageid_ = table_pageid;
+        return slot.frame_id_;
+    }
+
+    void BufferPool::FlushBuffers(FramePool &pool) {
+        // 持有页面锁的线程可能正在等待 pool 锁（如扩展表时调用 NewPage），写回时需等待页面锁，因此在 pool 锁外进行
+        std::vector<BufferPoolEntry> buffer_entries;
+        {
+            std::unique_lock lock(pool.latch_);
+            buffer_entries.assign(pool.buffers_.begin(), pool.buffers_.begin() + pool.used_frames_);
+        }
+        FlushPages(buffer_entries);
+    }
+
+    void BufferPool::ClearBuffers(FramePool &pool, size_t buffer_size, bool flush) {
+        // 持有全部分区锁期间其他线程无法通过页表 pin 页面
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        for (auto &partition : pool.page_table_) {
+            locks.emplace_back(partition.latch_);
+        }
+        // 仍被 pin 的页面留在缓存中，否则持有者之后的修改不会再写回，再次读取该页面时会得到磁盘上的旧版本
+        std::vector<BufferPoolEntry> pinned_entries;
+        std::vector<BufferPoolEntry> unpinned_entries;
+        for (size_t i = 0; i < pool.used_frames_; i++) {
+            if (pool.buffers_[i].page_ == nullptr) {
+                continue;
+            }
+            pool.buffers_[i].page_->WaitForWriteback();
+            if (pool.buffers_[i].page_.use_count() > 1) {
+                pinned_entries.push_back(pool.buffers_[i]);
             } else {
-                buffer_strategy_->Access(buffers_.size());
-                hashmap_[{table_oid, page_id}] = buffers_.size();
-                buffers_.push_back({db_oid, table_oid, page_id, page});
+                unpinned_entries.push_back(pool.buffers_[i]);
             }
         }
+        if (buffer_size != pool.buffer_size_ && !pinned_entries.empty()) {
+            throw DbException("Cannot resize buffer pool while pages are pinned");
+        }
+        if (flush) {
+            // 未被 pin 的页面不会被其他线程加锁，写回不会等待。FlushBuffers 之后再次被修改的页面在此写回
+            FlushPages(unpinned_entries);
+        }
+        unpinned_entries.clear();
+        for (auto &partition : pool.page_table_) {
+            partition.map_.clear();
+        }
+        if (buffer_size != pool.buffer_size_) {
+            pool.buffer_size_ = buffer_size;
+            pool.buffers_.assign(buffer_size, {});
+            pool.buffers_.shrink_to_fit();
+        } else {
+            pool.buffers_.assign(buffer_size, {});
+        }
+        pool.used_frames_ = pinned_entries.size();
+        pool.buffer_strategy_ = CreateBufferStrategy(buffer_size);
+        for (size_t i = 0; i < pinned_entries.size(); i++) {
+            const auto &entry = pinned_entries[i];
+            pool.buffers_[i] = entry;
+            pool.buffer_strategy_->Access(i);
+            GetPartition(pool, {entry.table_oid_, entry.page_id_}).map_[{entry.table_oid_, entry.page_id_}] = i;
+        }
     }
 
-    void BufferPool::FlushPage(size_t frame_id) {
-        auto &buffer_entry = buffers_[frame_id];
-        if (buffer_entry.page_->IsDirty()) {
+    void BufferPool::RemoveFrames(FramePool &pool, const std::function<bool(const BufferPoolEntry &)> &predicate) {
+        // 持有全部分区锁期间其他线程无法通过页表 pin 页面
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        for (auto &partition : pool.page_table_) {
+            locks.emplace_back(partition.latch_);
+        }
+        // 被 pin 的页面及仍为脏页的页面（如表已再次扩展到该页面号）保留在缓存中
+        std::vector<size_t> new_frame_ids(pool.used_frames_, NULL_FRAME_ID);
+        size_t used_frames = 0;
+        for (size_t i = 0; i < pool.used_frames_; i++) {
+            const auto &entry = pool.buffers_[i];
+            if (entry.page_ != nullptr && predicate(entry) && entry.page_.use_count() == 1 &&
+                !entry.page_->IsDirty()) {
+                GetPartition(pool, {entry.table_oid_, entry.page_id_}).map_.erase({entry.table_oid_, entry.page_id_});
+                continue;
+            }
+            new_frame_ids[i] = used_frames++;
+        }
+        if (used_frames == pool.used_frames_) {
+            return;
+        }
+        // 剩余的帧移到缓存的前部，按原替换策略的淘汰顺序重新登记，尽量保持页面的冷热顺序
+        auto eviction_order = pool.buffer_strategy_->GetEvictionCandidates(pool.used_frames_);
+        std::vector<BufferPoolEntry> buffers(pool.buffer_size_);
+        for (size_t i = 0; i < pool.used_frames_; i++) {
+            if (new_frame_ids[i] != NULL_FRAME_ID) {
+                auto &entry = pool.buffers_[i];
+                buffers[new_frame_ids[i]] = entry;
+                GetPartition(pool, {entry.table_oid_, entry.page_id_}).map_[{entry.table_oid_, entry.page_id_}] =
+                        new_frame_ids[i];
+            }
+        }
+        pool.buffers_ = std::move(buffers);
+        pool.used_frames_ = used_frames;
+        pool.buffer_strategy_ = CreateBufferStrategy(pool.buffer_size_);
+        for (auto frame_id : eviction_order) {
+            if (frame_id < new_frame_ids.size() && new_frame_ids[frame_id] != NULL_FRAME_ID) {
+                pool.buffer_strategy_->Access(new_frame_ids[frame_id]);
+            }
+        }
+    }
+
+    void BufferPool::WritePage(oid_t db_oid, oid_t table_oid, pageid_t page_id, const Page &page) {
+        disk_.WritePage(db_oid, table_oid, page_id, page.GetData());
+    }
+
+    bool BufferPool::FlushPage(const BufferPoolEntry &buffer_entry) {
+        std::shared_lock latch(buffer_entry.page_->GetLatch());
+        if (!buffer_entry.page_->IsDirty()) {
+            return false;
+        }
+        // 系统表不写日志，直接写回
+        if (buffer_entry.db_oid_ != SYSTEM_DATABASE_OID) {
             auto table_page = std::make_unique<TablePage>(buffer_entry.page_);
             log_manager_.FlushPage(buffer_entry.table_oid_, buffer_entry.page_id_, table_page->GetPageLSN());
-            assert(buffer_entry.db_oid_ != SYSTEM_DATABASE_OID);
-            disk_.WritePage(Disk::GetFilePath(buffer_entry.db_oid_, buffer_entry.table_oid_), buffer_entry.page_id_,
-                            buffer_entry.page_->GetData());
         }
-        hashmap_.erase({buffer_entry.table_oid_, buffer_entry.page_id_});
+        disk_.WritePage(buffer_entry.db_oid_, buffer_entry.table_oid_, buffer_entry.page_id_,
+                        buffer_entry.page_->GetData());
+        // 持有共享锁期间页面不会被修改，可以安全地清除脏标记
+        buffer_entry.page_->ClearDirty();
+        return true;
+    }
+
+    size_t BufferPool::FlushPages(const std::vector<BufferPoolEntry> &buffer_entries, bool skip_latched) {
+        auto page_size = disk_.GetPageSize();
+        auto copies = std::make_unique<char[]>(buffer_entries.size() * page_size);
+        std::vector<std::shared_ptr<Page>> flushed_pages;
+        std::vector<PageIO> requests;
+        for (const auto &entry : buffer_entries) {
+            if (entry.page_ == nullptr) {
+                continue;
+            }
+            std::shared_lock latch(entry.page_->GetLatch(), std::defer_lock);
+            if (skip_latched) {
+                if (!latch.try_lock()) {
+                    continue;
+                }
+            } else {
+                latch.lock();
+            }
+            if (!entry.page_->IsDirty()) {
+                continue;
+            }
+            if (entry.db_oid_ != SYSTEM_DATABASE_OID) {
+                auto table_page = std::make_unique<TablePage>(entry.page_);
+                log_manager_.FlushPage(entry.table_oid_, entry.page_id_, table_page->GetPageLSN());
+            }
+            char *copy = copies.get() + requests.size() * page_size;
+            std::memcpy(copy, entry.page_->GetData(), page_size);
+            entry.page_->ClearDirty();
+            flushed_pages.push_back(entry.page_);
+            requests.push_back({entry.db_oid_, entry.table_oid_, entry.page_id_, copy});
+        }
+        try {
+            disk_.WritePages(requests);
+        } catch (DbException &e) {
+            // 无法确定哪些页面已写入，全部重新标记为脏页
+            for (const auto &page : flushed_pages) {
+                page->SetDirty();
+            }
+            throw;
+        }
+        return requests.size();
+    }
+
+    void BufferPool::BackgroundWriterLoop(size_t delay_ms, size_t max_pages) {
+        std::unique_lock lock(bgwriter_mutex_);
+        while (!bgwriter_cv_.wait_for(lock, std::chrono::milliseconds(delay_ms), [this] { return bgwriter_stop_; })) {
+            lock.unlock();
+            size_t pages_written = 0;
+            for (auto *pool : {&buffers_, &systable_buffers_}) {
+                try {
+                    pages_written += BackgroundWriterRound(*pool, max_pages);
+                } catch (DbException &e) {
+                    // 写回失败的页面仍是脏页，由前台淘汰时再次写回
+                }
+            }
+            bgwriter_rounds_++;
+            bgwriter_pages_written_ += pages_written;
+            lock.lock();
+        }
+    }
+
+    size_t BufferPool::BackgroundWriterRound(FramePool &pool, size_t max_pages) {
+        // 持有 pool 锁时只收集候选页面。复制出的 shared_ptr 登记为写回引用，前台淘汰时等待写回完成而不是跳过这些页面
+        std::vector<BufferPoolEntry> dirty_entries;
+        {
+            std::unique_lock lock(pool.latch_);
+            for (auto frame_id : pool.buffer_strategy_->GetEvictionCandidates(max_pages)) {
+                const auto &entry = pool.buffers_[frame_id];
+                if (entry.page_ != nullptr && entry.page_->IsDirty()) {
+                    entry.page_->BeginWriteback();
+                    dirty_entries.push_back(entry);
+                }
+            }
+        }
+        size_t pages_written;
+        try {
+            // 前台线程可能持有页面锁等待写回完成，跳过正被加锁的页面以免互相等待
+            pages_written = FlushPages(dirty_entries, true);
+        } catch (DbException &e) {
+            EndWriteback(dirty_entries);
+            throw;
+        }
+        EndWriteback(dirty_entries);
+        return pages_written;
     }
 
-    void BufferPool::FlushSysTablePage(size_t frame_id) {
-        auto &buffer_entry = systable_buffers_[frame_id];
-        if (buffer_entry.page_->IsDirty()) {
-            assert(buffer_entry.db_oid_ == SYSTEM_DATABASE_OID);
-            disk_.WritePage(Disk::GetFilePath(buffer_entry.db_oid_, buffer_entry.table_oid_), buffer_entry.page_id_,
-                            buffer_entry.page_->GetData());
+    void BufferPool::EndWriteback(std::vector<BufferPoolEntry> &buffer_entries) {
+        for (auto &entry : buffer_entries) {
+            // 先释放引用再结束写回，等待写回的线程随后看到的引用计数不含后台写进程；帧在写回期间不会被替换，页面仍由缓存持有
+            auto *page = entry.page_.get();
+            entry.page_.reset();
+            page->EndWriteback();
         }
-        systable_hashmap_.erase({buffer_entry.table_oid_, buffer_entry.page_id_});
     }
 
 }  // namespace huadb
@@ -1,16 +1,29 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "common/constants.h"
 #include "common/types.h"
+#include "storage/buffer_strategy.h"
 #include "storage/disk.h"
-#include "storage/lru_buffer_strategy.h"
+#include "storage/frame_list.h"
 #include "storage/page.h"
 
 namespace huadb {
 
+    // 页表分区数，不同分区的查找互不阻塞
+    static constexpr size_t PAGE_TABLE_PARTITIONS = 16;
+
     struct BufferPoolEntry {
         oid_t db_oid_;
         oid_t table_oid_;
@@ -18,46 +31,208 @@ namespace huadb {
         std::shared_ptr<Page> page_;
     };
 
+    // 后台写进程统计信息
+    struct BackgroundWriterStats {
+        bool running_;
+        uint64_t rounds_;                 // 执行轮数
+        uint64_t pages_written_;          // 后台写进程写回的页面数
+        uint64_t backend_pages_written_;  // 前台淘汰时同步写回的页面数
+        double pages_per_second_;         // 后台写进程运行期间的平均写回速度
+    };
+
     class LogManager;
 
+    // 缓冲区访问策略：大表扫描使用的私有环形帧集合
+    // 扫描未命中时循环复用环中的帧读入页面，整个扫描至多占用 ring_size 个帧，不会挤出其他事务的常用页面
+    class BufferAccessStrategy {
+    public:
+        explicit BufferAccessStrategy(size_t ring_size);
+
+        size_t GetRingSize() const;
+
+    private:
+        friend class BufferPool;
+
+        struct RingSlot {
+            size_t frame_id_ = NULL_FRAME_ID;
+            TablePageid table_pageid_;  // 读入该帧的页面，帧被其他线程淘汰复用后与之不符
+        };
+
+        std::vector<RingSlot> ring_;
+        size_t current_ = 0;  // 下一个复用的槽位
+    };
+
+    // 线程安全的 buffer pool
+    // 普通表与系统表使用两组容量独立的缓存帧，各自按替换策略淘汰，互不挤占
+    // 调用者持有 GetPage/NewPage 返回的 shared_ptr 期间页面处于 pin 状态，不会被淘汰
+    // 读写页面内容时需通过 Page::GetLatch 加共享锁或排他锁
     class BufferPool {
     public:
-        BufferPool(Disk &disk, LogManager &log_manager);
+        BufferPool(Disk &disk, LogManager &log_manager, size_t buffer_size = DEFAULT_BUFFER_SIZE,
+                   size_t systable_buffer_size = DEFAULT_SYSTABLE_BUFFER_SIZE,
+                   BufferStrategyType buffer_strategy_type = BufferStrategyType::LRU);
+
+        ~BufferPool();
 
-        // 获取一个已经存在的页面
-        std::shared_ptr<Page> GetPage(oid_t db_oid, oid_t table_oid, pageid_t page_id);
+        // 获取一个已经存在的页面，strategy 非空时未命中的页面读入其环形帧中
+        std::shared_ptr<Page> GetPage(oid_t db_oid, oid_t table_oid, pageid_t page_id,
+                                      BufferAccessStrategy *strategy = nullptr);
 
         // 新建一个页面
         std::shared_ptr<Page> NewPage(oid_t db_oid, oid_t table_oid, pageid_t page_id);
 
+        // 批量预读一个表的多个页面，已缓存的页面跳过，读取失败的页面（如尚未写入磁盘的新页面）直接忽略
+        // 一次至多预读一半的缓存容量（使用 strategy 时为一半的环大小），返回处理了 page_ids 中的前多少个页面
+        // 同步 I/O 方式下预读与按需读取无异，直接返回 0
+        size_t PrefetchPages(oid_t db_oid, oid_t table_oid, const std::vector<pageid_t> &page_ids,
+                             BufferAccessStrategy *strategy = nullptr);
+
+        // 为表的顺序扫描创建环形缓冲区访问策略。环形缓冲区关闭或表不超过缓存容量的 1/4 时返回空指针
+        std::unique_ptr<BufferAccessStrategy> CreateScanStrategy(oid_t db_oid, oid_t table_oid);
+
+        // 大表扫描的环形缓冲区大小，为 0 时不使用环形缓冲区
+        size_t GetScanRingSize() const;
+
+        void SetScanRingSize(size_t scan_ring_size);
+
+        // 顺序扫描的预读页面数，为 0 时不预读
+        size_t GetReadAheadPages() const;
+
+        void SetReadAheadPages(size_t read_ahead_pages);
+
+        // 不经过缓存，直接将页面写入表文件，用于创建表文件时写入初始页面
+        void WritePage(oid_t db_oid, oid_t table_oid, pageid_t page_id, const Page &page);
+
+        // 将表文件截断为 page_count 个页面。被截断页面的缓存帧不再写回，等待这些页面正在进行的写回完成后截断文件
+        // 之后从缓存中移除这些帧，仍被 pin 的帧中残留的页面在表再次扩展到该页面号时由 NewPage 复用
+        void TruncateFile(oid_t db_oid, oid_t table_oid, pageid_t page_count);
+
         // 将所有页面刷到磁盘，regular_only 为 true 时只刷普通表页面
         void Flush(bool regular_only = false);
 
         // 清空 buffer pool，不刷脏，用于数据库故障模拟
         void Clear();
 
+        // 表或数据库的文件删除后调用，关闭缓存的文件描述符，之后对其残留页面的写回将被忽略
+        void CloseFile(oid_t db_oid, oid_t table_oid = INVALID_OID);
+
+        // 页面大小
+        size_t GetPageSize() const;
+
+        // 普通表缓存的页面数
+        size_t GetBufferSize() const;
+
+        // 修改缓存页面数，会先将普通表页面刷盘，有页面被 pin 时失败
+        void SetBufferSize(size_t buffer_size);
+
+        // 系统表缓存的页面数
+        size_t GetSysTableBufferSize() const;
+
+        // 修改系统表缓存页面数，会先将系统表页面刷盘，有页面被 pin 时失败
+        void SetSysTableBufferSize(size_t buffer_size);
+
+        // 切换缓存替换策略，已缓存的页面按帧号顺序重新登记到新策略中
+        void SetBufferStrategy(BufferStrategyType buffer_strategy_type);
+
+        // 启动后台写进程：每隔 delay_ms 毫秒，将每组缓存中即将被淘汰的至多 max_pages 个帧中的脏页写回
+        // 使前台淘汰时大多能直接得到干净的页面。已在运行时按新参数重启
+        void StartBackgroundWriter(size_t delay_ms, size_t max_pages);
+
+        // 停止后台写进程，需在日志管理器、磁盘析构前调用
+        void StopBackgroundWriter();
+
+        BackgroundWriterStats GetBackgroundWriterStats();
+
     private:
-        // 将页面加入 buffer pool
-        void AddToBuffer(oid_t db_oid, oid_t table_oid, pageid_t page_id, std::shared_ptr<Page> page);
+        struct PageTablePartition {
+            std::shared_mutex latch_;
+            std::unordered_map<TablePageid, size_t> map_;  // page_id 到 buffers_ 下标的映射
+        };
+
+        // 一组独立淘汰的缓存帧
+        struct FramePool {
+            // 保护替换策略及帧的分配、淘汰。未命中的页面读取在此锁内串行进行，命中路径不会等待此锁
+            std::mutex latch_;
+            std::unique_ptr<BufferStrategy> buffer_strategy_;  // 缓存替换策略
+            size_t buffer_size_;                                // 缓存容量
+            // 大小固定为 buffer_size_，前 used_frames_ 个帧已被使用
+            std::vector<BufferPoolEntry> buffers_;
+            size_t used_frames_ = 0;
+            // 分区页表
+            std::array<PageTablePartition, PAGE_TABLE_PARTITIONS> page_table_;
+        };
+
+        FramePool &GetFramePool(oid_t db_oid);
+
+        static PageTablePartition &GetPartition(FramePool &pool, const TablePageid &table_pageid);
+
+        // 在页表中查找页面，命中时返回页面并设置 frame_id，未命中返回空指针
+        static std::shared_ptr<Page> LookUp(FramePool &pool, const TablePageid &table_pageid, size_t &frame_id);
+
+        // 按当前策略类型新建替换策略
+        std::unique_ptr<BufferStrategy> CreateBufferStrategy(size_t buffer_size) const;
+
+        // 修改缓存容量，会先将页面刷盘，有页面被 pin 时抛出异常
+        void ResizeFramePool(FramePool &pool, size_t buffer_size);
+
+        // 将全部页面刷盘，调用时不能持有 pool.latch_：写回需要等待页面锁
+        void FlushBuffers(FramePool &pool);
+
+        // 以下函数调用时需持有 pool.latch_
+        // 将未缓存的页面加入 buffer pool，返回该页面
+        std::shared_ptr<Page> AddToBuffer(FramePool &pool, oid_t db_oid, oid_t table_oid, pageid_t page_id,
+                                          std::shared_ptr<Page> page, BufferAccessStrategy *strategy = nullptr);
+
+        // 分配一个空闲帧，缓存已满时淘汰一个未被 pin 的页面
+        size_t AllocateFrame(FramePool &pool);
+
+        // 为读入 table_pageid 分配环中的下一个帧：帧仍属于该环且未被 pin 时直接复用，否则另行分配一个帧加入环中
+        size_t AllocateRingFrame(FramePool &pool, BufferAccessStrategy &strategy, const TablePageid &table_pageid);
+
+        // 清空页面并将容量改为 buffer_size，仍被 pin 的页面保留在缓存中，修改容量时有页面被 pin 则抛出异常
+        // flush 为 true 时先写回未被 pin 的脏页
+        void ClearBuffers(FramePool &pool, size_t buffer_size, bool flush);
+
+        // 移除满足 predicate 且未被 pin 的干净页面，剩余的帧移到缓存前部并按原淘汰顺序重新登记到替换策略中
+        void RemoveFrames(FramePool &pool, const std::function<bool(const BufferPoolEntry &)> &predicate);
+
+        // 将脏页刷到磁盘，普通表页面刷盘前先刷对应的日志，返回是否写了磁盘
+        bool FlushPage(const BufferPoolEntry &buffer_entry);
+
+        // 批量将脏页刷到磁盘，返回写回的页面数。页面内容在页面锁内复制后统一提交，写回期间页面可继续被修改
+        // skip_latched 为 true 时跳过无法立即加锁的页面
+        size_t FlushPages(const std::vector<BufferPoolEntry> &buffer_entries, bool skip_latched = false);
+
+        // 后台写进程主循环
+        void BackgroundWriterLoop(size_t delay_ms, size_t max_pages);
 
-        // 将 buffer 中对应的页面刷到磁盘
-        void FlushPage(size_t frame_id);
+        // 后台写进程的一轮，返回写回的页面数
+        size_t BackgroundWriterRound(FramePool &pool, size_t max_pages);
 
-        // 将 systable_buffer 中对应的页面刷到磁盘
-        void FlushSysTablePage(size_t frame_id);
+        // 释放后台写进程对页面的引用并结束写回
+        static void EndWriteback(std::vector<BufferPoolEntry> &buffer_entries);
 
         Disk &disk_;
         LogManager &log_manager_;
-        std::unique_ptr<BufferStrategy> buffer_strategy_;  // 缓存替换策略
+        BufferStrategyType buffer_strategy_type_;  // 缓存替换策略类型
+        std::atomic<size_t> read_ahead_pages_ = DEFAULT_READ_AHEAD_PAGES;
+        std::atomic<size_t> scan_ring_size_ = DEFAULT_SCAN_RING_SIZE;
 
         // 普通表缓存
-        std::vector<BufferPoolEntry> buffers_;
-        // page_id 到 buffers_ 下标的映射
-        std::unordered_map<TablePageid, size_t> hashmap_;
+        FramePool buffers_;
         // 系统表专用缓存
-        std::vector<BufferPoolEntry> systable_buffers_;
-        // 系统表专用映射
-        std::unordered_map<TablePageid, size_t> systable_hashmap_;
+        FramePool systable_buffers_;
+
+        // 后台写进程，bgwriter_mutex_ 保护线程的启停及运行时间统计
+        std::thread bgwriter_thread_;
+        std::mutex bgwriter_mutex_;
+        std::condition_variable bgwriter_cv_;
+        bool bgwriter_stop_ = false;
+        std::chrono::steady_clock::time_point bgwriter_start_time_;
+        std::chrono::steady_clock::duration bgwriter_run_time_{0};  // 已停止的各次运行时间之和
+        std::atomic<uint64_t> bgwriter_rounds_ = 0;
+        std::atomic<uint64_t> bgwriter_pages_written_ = 0;
+        std::atomic<uint64_t> backend_pages_written_ = 0;
     };
 
 }  // namespace huadb
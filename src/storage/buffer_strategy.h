@@ -1,9 +1,13 @@
 #pragma once
 
 #include <cstddef>
+#include <vector>
 
 namespace huadb {
 
+// 缓存替换策略类型
+enum class BufferStrategyType { LRU, CLOCK, LRU_K, TWO_QUEUE };
+
 // 缓存替换策略的模板类
 class BufferStrategy {
  public:
@@ -12,6 +16,8 @@ class BufferStrategy {
   virtual void Access(size_t frame_no) = 0;
   // 页面替换接口
   virtual size_t Evict() = 0;
+  // 按淘汰顺序返回最多 count 个即将被淘汰的帧，不修改策略状态，供后台写进程提前刷脏
+  virtual std::vector<size_t> GetEvictionCandidates(size_t count) const = 0;
 };
 
 }  // namespace huadb
@@ -0,0 +1,53 @@
+#include "storage/clock_buffer_strategy.h"
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+ClockBufferStrategy::ClockBufferStrategy(size_t buffer_size)
+    : present_(buffer_size, false), referenced_(buffer_size, false) {}
+
+void ClockBufferStrategy::Access(size_t frame_no) {
+  if (!present_[frame_no]) {
+    present_[frame_no] = true;
+    present_count_++;
+  }
+  referenced_[frame_no] = true;
+}
+
+size_t ClockBufferStrategy::Evict() {
+  if (present_count_ == 0) {
+    throw DbException("No frame to evict in ClockBufferStrategy");
+  }
+  // 每个帧最多被扫过两次：第一次清除引用位，第二次被淘汰
+  while (true) {
+    auto frame_no = hand_;
+    hand_ = (hand_ + 1) % present_.size();
+    if (!present_[frame_no]) {
+      continue;
+    }
+    if (referenced_[frame_no]) {
+      referenced_[frame_no] = false;
+      continue;
+    }
+    present_[frame_no] = false;
+    present_count_--;
+    return frame_no;
+  }
+}
+
+std::vector<size_t> ClockBufferStrategy::GetEvictionCandidates(size_t count) const {
+  // 从时钟指针开始，先是引用位为 0 的帧，转过一圈后是引用位被清除的帧
+  std::vector<size_t> candidates;
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < present_.size() && candidates.size() < count; i++) {
+      auto frame_no = (hand_ + i) % present_.size();
+      if (present_[frame_no] && referenced_[frame_no] == referenced) {
+        candidates.push_back(frame_no);
+      }
+    }
+  }
+  return candidates;
+}
+
+}  // namespace huadb
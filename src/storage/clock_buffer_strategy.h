@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+#include "storage/buffer_strategy.h"
+
+namespace huadb {
+
+// CLOCK 替换策略：访问时设置引用位，淘汰时时钟指针依次清除引用位，直到找到引用位为 0 的帧
+class ClockBufferStrategy : public BufferStrategy {
+ public:
+  explicit ClockBufferStrategy(size_t buffer_size);
+  void Access(size_t frame_no) override;
+  size_t Evict() override;
+  std::vector<size_t> GetEvictionCandidates(size_t count) const override;
+
+ private:
+  std::vector<bool> present_;     // 帧是否参与替换
+  std::vector<bool> referenced_;  // 引用位
+  size_t present_count_ = 0;
+  size_t hand_ = 0;  // 时钟指针
+};
+
+}  // namespace huadb
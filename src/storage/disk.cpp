@@ -1,11 +1,19 @@
 #include "storage/disk.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
-#include <iostream>
+#include <fstream>
+#include <vector>
 
 #include "common/constants.h"
 #include "common/exceptions.h"
-#include "common/string_util.h"
+#include "storage/io_uring_backend.h"
+#include "storage/thread_pool_io_backend.h"
 
 namespace huadb {
 
@@ -26,13 +34,20 @@ Disk::Disk() {
     }
     log_segments = log_file_size / LOG_SEGMENT_SIZE;
   }
-  log_fs_.open(LOG_NAME, std::fstream::in | std::fstream::out | std::fstream::binary);
-  if (log_fs_.fail()) {
-    throw DbException("fstream failed in Disk::Disk");
+  log_fd_ = open(LOG_NAME, O_RDWR);
+  if (log_fd_ < 0) {
+    throw DbException(std::string("open ") + LOG_NAME + " failed: " + std::strerror(errno));
   }
 }
 
-Disk::~Disk() { ChangeDirectory(".."); }
+Disk::~Disk() {
+  {
+    std::unique_lock lock(files_mutex_);
+    files_.clear();
+  }
+  close(log_fd_);
+  ChangeDirectory("..");
+}
 
 bool Disk::DirectoryExists(const std::string &path) { return std::filesystem::is_directory(path); }
 
@@ -56,91 +71,335 @@ bool Disk::EmptyFile(const std::string &path) {
   return std::filesystem::is_empty(path);
 }
 
+size_t Disk::FileSize(const std::string &path) {
+  if (!FileExists(path)) {
+    throw DbException("file " + path + " does not exist");
+  }
+  return std::filesystem::file_size(path);
+}
+
 void Disk::CreateFile(const std::string &path) { std::ofstream ofs(path); }
 
 void Disk::RemoveFile(const std::string &path) { std::filesystem::remove(path); }
 
-void Disk::OpenFile(const std::string &path) {
-  hashmap_[path] = std::fstream(path, std::fstream::in | std::fstream::out | std::fstream::binary);
-  if (!hashmap_[path]) {
-    throw DbException("file " + path + " does not exist");
+void Disk::CloseFile(oid_t db_oid, oid_t table_oid) {
+  std::unique_lock lock(files_mutex_);
+  if (table_oid != INVALID_OID) {
+    files_.erase(GetFileKey(db_oid, table_oid));
+    return;
+  }
+  for (auto it = files_.begin(); it != files_.end();) {
+    if (static_cast<oid_t>(it->first >> 32) == db_oid) {
+      it = files_.erase(it);
+    } else {
+      ++it;
+    }
   }
 }
 
-void Disk::CloseFile(const std::string &path) { hashmap_.erase(path); }
+void Disk::ReadPage(oid_t db_oid, oid_t table_oid, pageid_t page_id, char *data) {
+  if (db_oid != SYSTEM_DATABASE_OID) {
+    access_count_++;
+  }
+  auto handle = GetFileHandle(db_oid, table_oid);
+  if (handle == nullptr) {
+    throw DbException("file " + GetFilePath(db_oid, table_oid) + " does not exist");
+  }
+  auto bytes = pread(handle->fd_, data, page_size_, static_cast<off_t>(page_id) * page_size_);
+  if (bytes != static_cast<ssize_t>(page_size_)) {
+    throw DbException(GetFilePath(db_oid, table_oid) + " read page " + std::to_string(page_id) + " failed: read " +
+                      std::to_string(bytes) + " bytes, expected " + std::to_string(page_size_) + " bytes");
+  }
+}
 
-void Disk::ReadPage(const std::string &path, pageid_t page_id, char *data) {
-  if (GetOid(path).first != SYSTEM_DATABASE_OID) {
+void Disk::WritePage(oid_t db_oid, oid_t table_oid, pageid_t page_id, const char *data) {
+  auto handle = GetFileHandle(db_oid, table_oid);
+  if (handle == nullptr) {
+    // 表已被删除
+    return;
+  }
+  if (db_oid != SYSTEM_DATABASE_OID) {
     access_count_++;
   }
-  if (hashmap_.count(path) == 0) {
-    OpenFile(path);
+  AllocatePages(*handle, page_id);
+  auto bytes = pwrite(handle->fd_, data, page_size_, static_cast<off_t>(page_id) * page_size_);
+  if (bytes != static_cast<ssize_t>(page_size_)) {
+    throw DbException(GetFilePath(db_oid, table_oid) + " write page " + std::to_string(page_id) + " failed: " +
+                      std::strerror(errno));
   }
-  auto &fs = hashmap_[path];
-  if (fs.fail()) {
-    throw DbException("fstream failed in Disk::ReadPage");
+  pages_unsynced_ = true;
+}
+
+size_t Disk::GetPageCount(oid_t db_oid, oid_t table_oid) {
+  auto handle = GetFileHandle(db_oid, table_oid);
+  if (handle == nullptr) {
+    return 0;
   }
-  fs.seekg(page_id * DB_PAGE_SIZE);
-  fs.read(data, DB_PAGE_SIZE);
-  if (fs.gcount() != DB_PAGE_SIZE) {
-    throw DbException(path + " read page " + std::to_string(page_id) + " failed: read " + std::to_string(fs.gcount()) +
-                      " bytes, expected " + std::to_string(DB_PAGE_SIZE) + " bytes");
+  struct stat file_stat;
+  if (fstat(handle->fd_, &file_stat) != 0) {
+    throw DbException(GetFilePath(db_oid, table_oid) + " fstat failed: " + std::strerror(errno));
   }
+  return file_stat.st_size / page_size_;
 }
 
-void Disk::WritePage(const std::string &path, pageid_t page_id, const char *data) {
-  if (!FileExists(path)) {
+void Disk::TruncateFile(oid_t db_oid, oid_t table_oid, pageid_t page_count) {
+  auto handle = GetFileHandle(db_oid, table_oid);
+  if (handle == nullptr) {
     return;
   }
-  if (hashmap_.count(path) == 0) {
-    OpenFile(path);
+  std::unique_lock lock(handle->allocate_mutex_);
+  struct stat file_stat;
+  if (fstat(handle->fd_, &file_stat) != 0) {
+    throw DbException(GetFilePath(db_oid, table_oid) + " fstat failed: " + std::strerror(errno));
   }
-  if (GetOid(path).first != SYSTEM_DATABASE_OID) {
-    access_count_++;
+  auto size = static_cast<off_t>(page_count) * page_size_;
+  if (file_stat.st_size <= size) {
+    return;
   }
-  auto &fs = hashmap_[path];
-  if (fs.fail()) {
-    throw DbException("fstream failed in Disk::WritePage");
+  // 截断同时释放预分配的空间
+  if (ftruncate(handle->fd_, size) != 0) {
+    throw DbException(GetFilePath(db_oid, table_oid) + " truncate failed: " + std::strerror(errno));
   }
-  fs.seekp(page_id * DB_PAGE_SIZE);
-  fs.write(data, DB_PAGE_SIZE);
-  fs.flush();
+  handle->allocated_pages_ = page_count;
+  pages_unsynced_ = true;
 }
 
-void Disk::ReadLog(uint32_t offset, uint32_t count, char *data) {
-  if (log_fs_.fail()) {
-    throw DbException("fstream failed in Disk::ReadLog");
+size_t Disk::GetExtentPages() const { return extent_pages_; }
+
+void Disk::SetExtentPages(size_t extent_pages) {
+  if (extent_pages == 0) {
+    throw DbException("extent_pages must be positive");
+  }
+  extent_pages_ = extent_pages;
+}
+
+void Disk::ReadPages(std::vector<PageIO> &requests) {
+  // 读写期间持有描述符，避免被并发关闭
+  std::vector<std::shared_ptr<FileHandle>> handles;
+  std::vector<IORequest> io_requests;
+  std::vector<size_t> indexes;
+  for (size_t i = 0; i < requests.size(); i++) {
+    auto &request = requests[i];
+    request.ok_ = false;
+    auto handle = GetFileHandle(request.db_oid_, request.table_oid_);
+    if (handle == nullptr) {
+      continue;
+    }
+    io_requests.push_back({handle->fd_, request.data_, page_size_,
+                           static_cast<off_t>(request.page_id_) * static_cast<off_t>(page_size_), false});
+    indexes.push_back(i);
+    handles.push_back(std::move(handle));
+  }
+  SubmitIO(io_requests);
+  for (size_t i = 0; i < io_requests.size(); i++) {
+    auto &request = requests[indexes[i]];
+    request.ok_ = io_requests[i].result_ == static_cast<ssize_t>(page_size_);
+    // 超出文件末尾的预读没有读到数据，不计入磁盘访问次数
+    if (request.ok_ && request.db_oid_ != SYSTEM_DATABASE_OID) {
+      access_count_++;
+    }
+  }
+}
+
+void Disk::WritePages(const std::vector<PageIO> &requests) {
+  std::vector<std::shared_ptr<FileHandle>> handles;
+  std::vector<IORequest> io_requests;
+  std::vector<size_t> indexes;
+  for (size_t i = 0; i < requests.size(); i++) {
+    const auto &request = requests[i];
+    auto handle = GetFileHandle(request.db_oid_, request.table_oid_);
+    if (handle == nullptr) {
+      // 表已被删除
+      continue;
+    }
+    if (request.db_oid_ != SYSTEM_DATABASE_OID) {
+      access_count_++;
+    }
+    AllocatePages(*handle, request.page_id_);
+    io_requests.push_back({handle->fd_, request.data_, page_size_,
+                           static_cast<off_t>(request.page_id_) * static_cast<off_t>(page_size_), true});
+    indexes.push_back(i);
+    handles.push_back(std::move(handle));
+  }
+  SubmitIO(io_requests);
+  if (!io_requests.empty()) {
+    pages_unsynced_ = true;
+  }
+  for (size_t i = 0; i < io_requests.size(); i++) {
+    if (io_requests[i].result_ != static_cast<ssize_t>(page_size_)) {
+      const auto &request = requests[indexes[i]];
+      auto error = io_requests[i].result_ < 0 ? std::strerror(-io_requests[i].result_) : "short write";
+      throw DbException(GetFilePath(request.db_oid_, request.table_oid_) + " write page " +
+                        std::to_string(request.page_id_) + " failed: " + error);
+    }
+  }
+}
+
+void Disk::SetIOMethod(IOMethod io_method, size_t io_depth) {
+  if (io_depth == 0 || io_depth > MAX_IO_DEPTH) {
+    throw DbException("io_depth must be between 1 and " + std::to_string(MAX_IO_DEPTH));
+  }
+  std::unique_lock lock(io_mutex_);
+  io_backend_.reset();
+  if (io_method == IOMethod::IO_URING) {
+    io_backend_ = IOUringBackend::Create(io_depth);
+    if (io_backend_ == nullptr) {
+      io_method = IOMethod::THREAD_POOL;
+    }
+  }
+  if (io_method == IOMethod::THREAD_POOL) {
+    io_backend_ = std::make_unique<ThreadPoolIOBackend>(io_depth);
   }
-  log_fs_.seekg(offset);
-  log_fs_.read(data, count);
-  if (log_fs_.gcount() != count) {
+  io_method_ = io_method;
+}
+
+IOMethod Disk::GetIOMethod() const { return io_method_; }
+
+void Disk::SyncPages() {
+  if (!pages_unsynced_.exchange(false)) {
+    return;
+  }
+  std::vector<std::shared_ptr<FileHandle>> handles;
+  {
+    std::shared_lock lock(files_mutex_);
+    handles.reserve(files_.size());
+    for (const auto &[key, handle] : files_) {
+      handles.push_back(handle);
+    }
+  }
+  for (const auto &handle : handles) {
+    if (fdatasync(handle->fd_) != 0) {
+      throw DbException(std::string("fdatasync failed in Disk::SyncPages: ") + std::strerror(errno));
+    }
+  }
+}
+
+void Disk::ReadLog(uint32_t offset, uint32_t count, char *data) {
+  auto bytes = pread(log_fd_, data, count, offset);
+  if (bytes != static_cast<ssize_t>(count)) {
     throw DbException("read log failed (offset: " + std::to_string(offset) + ", count: " + std::to_string(count) +
-                      ", read: " + std::to_string(log_fs_.gcount()) + ")");
+                      ", read: " + std::to_string(bytes) + ")");
   }
 }
 
 void Disk::WriteLog(uint32_t offset, uint32_t count, const char *data) {
-  if (log_fs_.fail()) {
-    throw DbException("fstream failed in Disk::WriteLog");
+  {
+    std::unique_lock lock(log_mutex_);
+    // 批量写入的日志可能跨越多个段
+    if (offset + count > log_segments * LOG_SEGMENT_SIZE) {
+      while (offset + count > log_segments * LOG_SEGMENT_SIZE) {
+        log_segments++;
+      }
+      std::filesystem::resize_file(LOG_NAME, log_segments * LOG_SEGMENT_SIZE);
+    }
+  }
+  auto bytes = pwrite(log_fd_, data, count, offset);
+  if (bytes != static_cast<ssize_t>(count)) {
+    throw DbException("write log failed (offset: " + std::to_string(offset) + ", count: " + std::to_string(count) +
+                      "): " + std::strerror(errno));
   }
-  if (offset + count > log_segments * LOG_SEGMENT_SIZE) {
-    log_segments++;
-    std::filesystem::resize_file(LOG_NAME, log_segments * LOG_SEGMENT_SIZE);
+}
+
+void Disk::SyncLog() {
+  if (fdatasync(log_fd_) != 0) {
+    throw DbException(std::string("fdatasync failed in Disk::SyncLog: ") + std::strerror(errno));
   }
-  log_fs_.seekp(offset);
-  log_fs_.write(data, count);
-  log_fs_.flush();
 }
 
 uint32_t Disk::GetAccessCount() const { return access_count_; }
 
+size_t Disk::GetPageSize() const { return page_size_; }
+
+void Disk::SetPageSize(size_t page_size) {
+  if (!IsValidPageSize(page_size)) {
+    throw DbException("Invalid page size " + std::to_string(page_size));
+  }
+  page_size_ = page_size;
+}
+
 std::string Disk::GetFilePath(oid_t db_oid, oid_t table_oid) {
   return std::to_string(db_oid) + "/" + std::to_string(table_oid);
 }
 
-std::pair<oid_t, oid_t> Disk::GetOid(const std::string &path) {
-  auto oids = StringUtil::Split(path, '/');
-  return {std::stoi(oids[0]), std::stoi(oids[1])};
+std::string Disk::GetFsmPath(oid_t db_oid, oid_t table_oid) { return GetFilePath(db_oid, table_oid) + "_fsm"; }
+
+Disk::FileHandle::~FileHandle() { close(fd_); }
+
+void Disk::SubmitIO(std::vector<IORequest> &requests) {
+  std::shared_lock lock(io_mutex_);
+  if (io_backend_ != nullptr) {
+    io_backend_->Submit(requests);
+    return;
+  }
+  for (auto &request : requests) {
+    if (request.write_) {
+      request.result_ = pwrite(request.fd_, request.data_, request.size_, request.offset_);
+    } else {
+      request.result_ = pread(request.fd_, request.data_, request.size_, request.offset_);
+    }
+    if (request.result_ < 0) {
+      request.result_ = -errno;
+    }
+  }
+}
+
+uint64_t Disk::GetFileKey(oid_t db_oid, oid_t table_oid) {
+  return (static_cast<uint64_t>(db_oid) << 32) | static_cast<uint32_t>(table_oid);
+}
+
+std::shared_ptr<Disk::FileHandle> Disk::GetFileHandle(oid_t db_oid, oid_t table_oid) {
+  auto key = GetFileKey(db_oid, table_oid);
+  {
+    std::shared_lock lock(files_mutex_);
+    auto entry = files_.find(key);
+    if (entry != files_.end()) {
+      return entry->second;
+    }
+  }
+  std::unique_lock lock(files_mutex_);
+  auto entry = files_.find(key);
+  if (entry != files_.end()) {
+    return entry->second;
+  }
+  int fd = open(GetFilePath(db_oid, table_oid).c_str(), O_RDWR);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return nullptr;
+    }
+    throw DbException("open " + GetFilePath(db_oid, table_oid) + " failed: " + std::strerror(errno));
+  }
+  if (files_.size() >= MAX_OPEN_FILES) {
+    // 缓存已满时关闭任意一个描述符，正在使用它的线程仍持有 shared_ptr，不受影响
+    // 被关闭的文件可能有尚未同步的写入，需先同步，保证之后的 SyncPages 仍能覆盖这些写入
+    fdatasync(files_.begin()->second->fd_);
+    files_.erase(files_.begin());
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw DbException(GetFilePath(db_oid, table_oid) + " fstat failed: " + std::strerror(errno));
+  }
+  auto handle = std::make_shared<FileHandle>(fd, file_stat.st_size / page_size_);
+  files_.emplace(key, handle);
+  return handle;
+}
+
+void Disk::AllocatePages(FileHandle &handle, pageid_t page_id) {
+  if (page_id < handle.allocated_pages_) {
+    return;
+  }
+  std::unique_lock lock(handle.allocate_mutex_);
+  if (page_id < handle.allocated_pages_) {
+    return;
+  }
+  size_t extent_pages = extent_pages_;
+  size_t allocated_pages = (page_id / extent_pages + 1) * extent_pages;
+  if (extent_pages > 1) {
+    // 只分配空间、不改变文件大小，文件中的页面数仍由写入的页面决定。文件系统不支持时由写入时分配，无需处理
+    fallocate(handle.fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(handle.allocated_pages_) * page_size_,
+              static_cast<off_t>(allocated_pages - handle.allocated_pages_) * page_size_);
+  }
+  handle.allocated_pages_ = allocated_pages;
 }
 
 }  // namespace huadb
@@ -1,14 +1,28 @@
 #pragma once
 
-#include <fstream>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
-#include <utility>
+#include <vector>
 
+#include "common/constants.h"
 #include "common/types.h"
+#include "storage/io_backend.h"
 
 namespace huadb {
 
+    // 批量读写中的一个页面
+    struct PageIO {
+        oid_t db_oid_;
+        oid_t table_oid_;
+        pageid_t page_id_;
+        char *data_;
+        bool ok_ = false;  // 读取是否成功，由 ReadPages 设置
+    };
+
     class Disk {
     public:
         Disk();
@@ -27,34 +41,104 @@ namespace huadb {
 
         static bool EmptyFile(const std::string &path);
 
+        static size_t FileSize(const std::string &path);
+
         static void CreateFile(const std::string &path);
 
         static void RemoveFile(const std::string &path);
 
-        void OpenFile(const std::string &path);
+        // 关闭表文件的描述符，删除表或数据库前调用；table_oid 为 INVALID_OID 时关闭整个数据库的文件
+        void CloseFile(oid_t db_oid, oid_t table_oid = INVALID_OID);
+
+        // 通过 pread/pwrite 读写表文件中的页面，可由多个线程并发调用
+        // 写入的表文件已被删除时直接忽略
+        void ReadPage(oid_t db_oid, oid_t table_oid, pageid_t page_id, char *data);
+
+        void WritePage(oid_t db_oid, oid_t table_oid, pageid_t page_id, const char *data);
+
+        // 表文件中已写入的页面数，文件不存在时返回 0
+        size_t GetPageCount(oid_t db_oid, oid_t table_oid);
+
+        // 将表文件截断为 page_count 个页面，文件不足 page_count 个页面或不存在时不做处理
+        void TruncateFile(oid_t db_oid, oid_t table_oid, pageid_t page_count);
+
+        // 表文件按区段分配磁盘空间，写入超出已分配范围的页面时一次预分配 extent_pages 个页面的空间，
+        // 避免每写入一个新页面都修改一次文件的元数据。为 1 时不预分配
+        size_t GetExtentPages() const;
+
+        void SetExtentPages(size_t extent_pages);
 
-        void CloseFile(const std::string &path);
+        // 批量读取页面，各页面按当前 I/O 方式并发读取、乱序完成，全部完成后返回
+        // 表文件不存在或页面超出文件末尾的请求不抛出异常，ok_ 置为 false，用于预读等可以失败的场景
+        void ReadPages(std::vector<PageIO> &requests);
 
-        void ReadPage(const std::string &path, pageid_t page_id, char *data);
+        // 批量写回页面，全部完成后返回，任一页面写入失败时抛出异常。表文件已被删除的页面直接忽略
+        void WritePages(const std::vector<PageIO> &requests);
 
-        void WritePage(const std::string &path, pageid_t page_id, const char *data);
+        // 切换批量读写方式，io_depth 为线程池的线程数或 io_uring 的队列深度
+        // 内核不支持 io_uring 时退回线程池
+        void SetIOMethod(IOMethod io_method, size_t io_depth);
+
+        // 实际使用的批量读写方式
+        IOMethod GetIOMethod() const;
+
+        // 将已写入的表文件页面持久化，在检查点、关闭数据库时调用
+        void SyncPages();
 
         void ReadLog(uint32_t offset, uint32_t count, char *data);
 
         void WriteLog(uint32_t offset, uint32_t count, const char *data);
 
+        // 将已写入的日志持久化，在日志刷盘（事务提交、WAL 先于数据页写回）时调用
+        void SyncLog();
+
         uint32_t GetAccessCount() const;
 
-        static std::string GetFilePath(oid_t db_oid, oid_t table_oid);
+        // 页面大小，由控制文件确定
+        size_t GetPageSize() const;
 
-    private:
-        static std::pair<oid_t, oid_t> GetOid(const std::string &path);
+        void SetPageSize(size_t page_size);
+
+        static std::string GetFilePath(oid_t db_oid, oid_t table_oid);
 
-        std::unordered_map<std::string, std::fstream> hashmap_;  // 文件路径到 fstream 的映射表
-        std::fstream log_fs_;
+        // 表的空闲空间映射文件
+        static std::string GetFsmPath(oid_t db_oid, oid_t table_oid);
 
-        uint32_t access_count_ = 0;  // 磁盘访问次数
+    private:
+        // 文件描述符，析构时关闭。读写期间持有 shared_ptr，避免描述符在使用中被关闭
+        struct FileHandle {
+            FileHandle(int fd, size_t allocated_pages) : fd_(fd), allocated_pages_(allocated_pages) {}
+            ~FileHandle();
+            int fd_;
+            std::atomic<size_t> allocated_pages_;  // 已分配磁盘空间的页面数，不小于文件中的页面数
+            std::mutex allocate_mutex_;            // 保护空间的分配与文件的截断
+        };
+
+        static uint64_t GetFileKey(oid_t db_oid, oid_t table_oid);
+
+        // 获取表文件的描述符，未缓存时打开文件，文件不存在时返回空指针
+        std::shared_ptr<FileHandle> GetFileHandle(oid_t db_oid, oid_t table_oid);
+
+        // 写入 page_id 前为其所在的区段分配磁盘空间
+        void AllocatePages(FileHandle &handle, pageid_t page_id);
+
+        // 按当前 I/O 方式执行一批请求
+        void SubmitIO(std::vector<IORequest> &requests);
+
+        std::unordered_map<uint64_t, std::shared_ptr<FileHandle>> files_;  // (db_oid, table_oid) 到文件描述符的映射
+        std::shared_mutex files_mutex_;
+        int log_fd_ = -1;
+        std::mutex log_mutex_;  // 保护日志文件的扩展
+
+        std::atomic<IOMethod> io_method_ = IOMethod::SYNC;
+        std::unique_ptr<IOBackend> io_backend_;  // SYNC 方式下为空
+        std::shared_mutex io_mutex_;             // 保护 I/O 方式的切换
+
+        size_t page_size_ = DEFAULT_PAGE_SIZE;  // 页面大小
+        std::atomic<size_t> extent_pages_ = DEFAULT_EXTENT_PAGES;  // 每次预分配的页面数
+        std::atomic<uint32_t> access_count_ = 0;  // 磁盘访问次数
         uint32_t log_segments = 0;   // 日志段数
+        std::atomic<bool> pages_unsynced_ = false;  // 上次 SyncPages 后是否写过表文件
     };
 
 }  // namespace huadb
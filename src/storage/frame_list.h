@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace huadb {
+
+static constexpr size_t NULL_FRAME_ID = -1;
+
+// 以帧号为下标的侵入式双向链表，插入、删除均为 O(1)
+// 表头为最近加入的帧，表尾为最早加入的帧
+class FrameList {
+ public:
+  explicit FrameList(size_t capacity)
+      : prev_(capacity, NULL_FRAME_ID), next_(capacity, NULL_FRAME_ID), in_list_(capacity, false) {}
+
+  bool Contains(size_t frame_no) const { return in_list_[frame_no]; }
+
+  bool Empty() const { return size_ == 0; }
+
+  size_t Size() const { return size_; }
+
+  size_t Back() const { return tail_; }
+
+  // 从表尾向表头遍历时的下一个帧
+  size_t Prev(size_t frame_no) const { return prev_[frame_no]; }
+
+  void PushFront(size_t frame_no) {
+    prev_[frame_no] = NULL_FRAME_ID;
+    next_[frame_no] = head_;
+    if (head_ != NULL_FRAME_ID) {
+      prev_[head_] = frame_no;
+    } else {
+      tail_ = frame_no;
+    }
+    head_ = frame_no;
+    in_list_[frame_no] = true;
+    size_++;
+  }
+
+  void Remove(size_t frame_no) {
+    if (prev_[frame_no] != NULL_FRAME_ID) {
+      next_[prev_[frame_no]] = next_[frame_no];
+    } else {
+      head_ = next_[frame_no];
+    }
+    if (next_[frame_no] != NULL_FRAME_ID) {
+      prev_[next_[frame_no]] = prev_[frame_no];
+    } else {
+      tail_ = prev_[frame_no];
+    }
+    in_list_[frame_no] = false;
+    size_--;
+  }
+
+ private:
+  std::vector<size_t> prev_;
+  std::vector<size_t> next_;
+  std::vector<bool> in_list_;
+  size_t head_ = NULL_FRAME_ID;
+  size_t tail_ = NULL_FRAME_ID;
+  size_t size_ = 0;
+};
+
+}  // namespace huadb
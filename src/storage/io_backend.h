@@ -0,0 +1,31 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace huadb {
+
+// 磁盘批量读写方式：SYNC 在调用线程中逐个读写；THREAD_POOL 由线程池并发读写；IO_URING 通过 io_uring 一次提交
+enum class IOMethod { SYNC, THREAD_POOL, IO_URING };
+
+// 一次读写请求
+struct IORequest {
+  int fd_;
+  char *data_;
+  size_t size_;
+  off_t offset_;
+  bool write_;
+  ssize_t result_ = 0;  // 完成后为实际读写的字节数，失败时为 -errno
+};
+
+// 异步 I/O 后端的模板类
+class IOBackend {
+ public:
+  virtual ~IOBackend() = default;
+  // 提交一批请求，请求之间可乱序完成，全部完成后返回。可由多个线程并发调用
+  virtual void Submit(std::vector<IORequest> &requests) = 0;
+};
+
+}  // namespace huadb
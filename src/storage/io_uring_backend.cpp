@@ -0,0 +1,138 @@
+#include "storage/io_uring_backend.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+std::unique_ptr<IOUringBackend> IOUringBackend::Create(unsigned entries) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_fd < 0) {
+    return nullptr;
+  }
+  auto backend = std::unique_ptr<IOUringBackend>(new IOUringBackend(ring_fd));
+  if (!backend->MapRings(params)) {
+    return nullptr;
+  }
+  return backend;
+}
+
+IOUringBackend::IOUringBackend(int ring_fd) : ring_fd_(ring_fd) {}
+
+IOUringBackend::~IOUringBackend() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  close(ring_fd_);
+}
+
+bool IOUringBackend::MapRings(const io_uring_params &params) {
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  auto *sq_ring = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                       IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    return false;
+  }
+  sq_ring_ = sq_ring;
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    auto *cq_ring = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                         IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) {
+      return false;
+    }
+    cq_ring_ = cq_ring;
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  auto *sqes =
+      mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  auto *sq_base = static_cast<char *>(sq_ring_);
+  auto *cq_base = static_cast<char *>(cq_ring_);
+  sq_entries_ = params.sq_entries;
+  sq_head_ = reinterpret_cast<unsigned *>(sq_base + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq_base + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq_base + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq_base + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned *>(cq_base + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq_base + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq_base + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(cq_base + params.cq_off.cqes);
+  return true;
+}
+
+void IOUringBackend::Submit(std::vector<IORequest> &requests) {
+  std::unique_lock lock(mutex_);
+  // readv/writev 自 5.1 起可用，比 read/write 操作码支持的内核版本更早
+  std::vector<iovec> iovecs(requests.size());
+  size_t submitted = 0;
+  size_t completed = 0;
+  while (completed < requests.size()) {
+    // 在途请求数不超过提交队列深度，完成队列（深度为其两倍）不会溢出
+    unsigned tail = *sq_tail_;
+    while (submitted < requests.size() && submitted - completed < sq_entries_) {
+      auto &request = requests[submitted];
+      iovecs[submitted] = {request.data_, request.size_};
+      unsigned index = tail & *sq_mask_;
+      auto &sqe = sqes_[index];
+      std::memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode = request.write_ ? IORING_OP_WRITEV : IORING_OP_READV;
+      sqe.fd = request.fd_;
+      sqe.addr = reinterpret_cast<uint64_t>(&iovecs[submitted]);
+      sqe.len = 1;
+      sqe.off = request.offset_;
+      sqe.user_data = submitted;
+      sq_array_[index] = index;
+      tail++;
+      submitted++;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+    // 提交尚未被内核取走的请求，并等待至少一个请求完成
+    unsigned to_submit = tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (syscall(__NR_io_uring_enter, ring_fd_, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        // EBADF、EFAULT 等错误说明 io_uring 实例已不可用，无法继续等待在途请求
+        throw DbException(std::string("io_uring_enter failed: ") + std::strerror(errno));
+      }
+    }
+
+    unsigned head = *cq_head_;
+    while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      const auto &cqe = cqes_[head & *cq_mask_];
+      requests[cqe.user_data].result_ = cqe.res;
+      head++;
+      completed++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+}
+
+}  // namespace huadb
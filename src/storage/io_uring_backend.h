@@ -0,0 +1,50 @@
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "storage/io_backend.h"
+
+namespace huadb {
+
+// io_uring I/O 后端，直接通过系统调用使用 io_uring，不依赖 liburing
+// 一批请求尽量一次填入提交队列，由内核并发执行并乱序完成；提交队列满时等待部分请求完成后继续提交
+class IOUringBackend : public IOBackend {
+ public:
+  // 创建深度为 entries 的 io_uring 实例，内核不支持或被禁用时返回空指针
+  static std::unique_ptr<IOUringBackend> Create(unsigned entries);
+
+  ~IOUringBackend() override;
+  void Submit(std::vector<IORequest> &requests) override;
+
+ private:
+  explicit IOUringBackend(int ring_fd);
+
+  // 映射提交队列、完成队列及 sqe 数组，失败时返回 false
+  bool MapRings(const io_uring_params &params);
+
+  int ring_fd_;
+  std::mutex mutex_;  // 一个 io_uring 实例同一时刻只处理一批请求
+
+  void *sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void *cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe *sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  unsigned sq_entries_ = 0;
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned *sq_mask_ = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned *cq_mask_ = nullptr;
+  io_uring_cqe *cqes_ = nullptr;
+};
+
+}  // namespace huadb
@@ -1,20 +1,38 @@
 #include "storage/lru_buffer_strategy.h"
 
+#include "common/exceptions.h"
+
 namespace huadb {
 
+    LRUBufferStrategy::LRUBufferStrategy(size_t buffer_size) : lru_buffer_(buffer_size) {}
+
     void LRUBufferStrategy::Access(size_t frame_no) {
         // 缓存页面访问
         // LAB 1 BEGIN
-        lru_buffer_.remove(frame_no);
-        lru_buffer_.emplace_front(frame_no);
+        if (lru_buffer_.Contains(frame_no)) {
+            lru_buffer_.Remove(frame_no);
+        }
+        lru_buffer_.PushFront(frame_no);
     };
 
     size_t LRUBufferStrategy::Evict() {
         // 缓存页面淘汰，返回淘汰的页面在 buffer pool 中的下标
         // LAB 1 BEGIN
-        auto last = lru_buffer_.back();
-        lru_buffer_.pop_back();
+        if (lru_buffer_.Empty()) {
+            throw DbException("No frame to evict in LRUBufferStrategy");
+        }
+        auto last = lru_buffer_.Back();
+        lru_buffer_.Remove(last);
         return last;
     }
 
+    std::vector<size_t> LRUBufferStrategy::GetEvictionCandidates(size_t count) const {
+        std::vector<size_t> candidates;
+        for (auto frame_no = lru_buffer_.Back(); frame_no != NULL_FRAME_ID && candidates.size() < count;
+             frame_no = lru_buffer_.Prev(frame_no)) {
+            candidates.push_back(frame_no);
+        }
+        return candidates;
+    }
+
 }  // namespace huadb
@@ -1,16 +1,19 @@
 #pragma once
 
 #include "storage/buffer_strategy.h"
-#include <list>
+#include "storage/frame_list.h"
 
 namespace huadb {
 
     class LRUBufferStrategy : public BufferStrategy {
     public:
+        explicit LRUBufferStrategy(size_t buffer_size);
         void Access(size_t frame_no) override;
         size_t Evict() override;
+        std::vector<size_t> GetEvictionCandidates(size_t count) const override;
     private:
-        std::list<size_t> lru_buffer_;
+        // 表头为最近访问的帧
+        FrameList lru_buffer_;
     };
 
 }  // namespace huadb
@@ -0,0 +1,55 @@
+#include "storage/lru_k_buffer_strategy.h"
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+LRUKBufferStrategy::LRUKBufferStrategy(size_t buffer_size, size_t k) : k_(k), history_(buffer_size) {
+  if (k_ == 0) {
+    throw DbException("k must be positive in LRUKBufferStrategy");
+  }
+}
+
+void LRUKBufferStrategy::Access(size_t frame_no) {
+  auto &history = history_[frame_no];
+  if (!history.empty()) {
+    if (frame_no == last_frame_) {
+      return;
+    }
+    evict_order_.erase(GetKey(frame_no));
+  }
+  history.push_back(current_timestamp_++);
+  if (history.size() > k_) {
+    history.pop_front();
+  }
+  evict_order_.insert(GetKey(frame_no));
+  last_frame_ = frame_no;
+}
+
+size_t LRUKBufferStrategy::Evict() {
+  if (evict_order_.empty()) {
+    throw DbException("No frame to evict in LRUKBufferStrategy");
+  }
+  auto frame_no = evict_order_.begin()->second;
+  evict_order_.erase(evict_order_.begin());
+  history_[frame_no].clear();
+  if (last_frame_ == frame_no) {
+    last_frame_ = NULL_FRAME_ID;
+  }
+  return frame_no;
+}
+
+std::vector<size_t> LRUKBufferStrategy::GetEvictionCandidates(size_t count) const {
+  std::vector<size_t> candidates;
+  for (auto it = evict_order_.begin(); it != evict_order_.end() && candidates.size() < count; ++it) {
+    candidates.push_back(it->second);
+  }
+  return candidates;
+}
+
+LRUKBufferStrategy::EvictKey LRUKBufferStrategy::GetKey(size_t frame_no) const {
+  const auto &history = history_[frame_no];
+  return {{history.size() >= k_, history.front()}, frame_no};
+}
+
+}  // namespace huadb
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <deque>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "storage/buffer_strategy.h"
+#include "storage/frame_list.h"
+
+namespace huadb {
+
+static constexpr size_t DEFAULT_LRU_K = 2;
+
+// LRU-K 替换策略：淘汰倒数第 k 次访问距今最久的帧，访问不足 k 次的帧优先淘汰（按最早访问时间）
+// 对同一帧的连续访问（如顺序扫描逐条读取同一页面的记录）视为相关访问，只记一次
+class LRUKBufferStrategy : public BufferStrategy {
+ public:
+  explicit LRUKBufferStrategy(size_t buffer_size, size_t k = DEFAULT_LRU_K);
+  void Access(size_t frame_no) override;
+  size_t Evict() override;
+  std::vector<size_t> GetEvictionCandidates(size_t count) const override;
+
+ private:
+  // 淘汰顺序的排序键：(是否已访问 k 次, 保留的最早访问时间, 帧号)
+  using EvictKey = std::pair<std::pair<bool, size_t>, size_t>;
+  EvictKey GetKey(size_t frame_no) const;
+
+  size_t k_;
+  size_t current_timestamp_ = 0;
+  size_t last_frame_ = NULL_FRAME_ID;
+  std::vector<std::deque<size_t>> history_;  // 每个帧最近 k 次访问的时间戳，为空表示帧不参与替换
+  std::set<EvictKey> evict_order_;
+};
+
+}  // namespace huadb
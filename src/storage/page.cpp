@@ -1,17 +1,35 @@
 #include "storage/page.h"
 
+#include <thread>
+
 #include "common/constants.h"
 
 namespace huadb {
 
-Page::Page() { data_ = new char[DB_PAGE_SIZE]; }
+Page::Page(size_t page_size) : size_(page_size) { data_ = new char[size_]; }
 
 Page::~Page() { delete[] data_; }
 
 void Page::SetDirty() { is_dirty_ = true; }
 
+void Page::ClearDirty() { is_dirty_ = false; }
+
 bool Page::IsDirty() const { return is_dirty_; }
 
 char *Page::GetData() const { return data_; }
 
+size_t Page::GetSize() const { return size_; }
+
+std::shared_mutex &Page::GetLatch() { return latch_; }
+
+void Page::BeginWriteback() { writeback_count_++; }
+
+void Page::EndWriteback() { writeback_count_--; }
+
+void Page::WaitForWriteback() const {
+  while (writeback_count_ > 0) {
+    std::this_thread::yield();
+  }
+}
+
 }  // namespace huadb
@@ -1,22 +1,45 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <shared_mutex>
+
 namespace huadb {
 
     class Page {
     public:
-        Page();
+        explicit Page(size_t page_size);
 
         ~Page();
 
         void SetDirty();
 
+        // 页面写回磁盘后清除脏标记，调用时需持有页面锁
+        void ClearDirty();
+
         bool IsDirty() const;
 
         char *GetData() const;
 
+        // 页面大小
+        size_t GetSize() const;
+
+        // 页面读写锁，读页面内容时加共享锁，修改页面内容时加排他锁
+        std::shared_mutex &GetLatch();
+
+        // 后台写进程写回期间对页面的引用不视为 pin，淘汰页面时等待写回完成
+        void BeginWriteback();
+
+        void EndWriteback();
+
+        void WaitForWriteback() const;
+
     private:
         char *data_;
-        bool is_dirty_ = false;
+        size_t size_;
+        std::atomic<bool> is_dirty_ = false;
+        std::atomic<size_t> writeback_count_ = 0;
+        std::shared_mutex latch_;
     };
 
 }  // namespace huadb
@@ -0,0 +1,149 @@
+#include "storage/temp_file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "common/constants.h"
+#include "common/exceptions.h"
+#include "storage/disk.h"
+
+namespace huadb {
+
+TempFile::TempFile() : buffer_(BUFFER_SIZE) {
+  static std::atomic<uint64_t> next_id = 0;
+  auto directory = std::to_string(TEMP_DATABASE_OID);
+  Disk::CreateDirectory(directory);
+  auto path = directory + "/temp_" + std::to_string(getpid()) + "_" + std::to_string(next_id++);
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd_ < 0) {
+    throw DbException("Cannot create temp file " + path + ": " + std::strerror(errno));
+  }
+  unlink(path.c_str());
+}
+
+TempFile::~TempFile() { close(fd_); }
+
+void TempFile::Append(const Record &record) {
+  if (reading_) {
+    throw DbException("Cannot append to a temp file being read");
+  }
+  const auto &values = record.GetValues();
+  // 记录长度、值的个数，之后每个值为类型、空值标记与值的内容
+  uint32_t size = sizeof(uint16_t);
+  for (const auto &value : values) {
+    size += 2;
+    if (!value.IsNull()) {
+      size += value.GetSize() + (TypeUtil::IsString(value.GetType()) ? sizeof(db_size_t) : 0);
+    }
+  }
+  if (buffer_end_ + sizeof(size) + size > buffer_.size()) {
+    FlushBuffer();
+    if (sizeof(size) + size > buffer_.size()) {
+      buffer_.resize(sizeof(size) + size);
+    }
+  }
+  char *data = buffer_.data() + buffer_end_;
+  memcpy(data, &size, sizeof(size));
+  data += sizeof(size);
+  auto value_count = static_cast<uint16_t>(values.size());
+  memcpy(data, &value_count, sizeof(value_count));
+  data += sizeof(value_count);
+  for (const auto &value : values) {
+    *data++ = static_cast<char>(value.GetType());
+    *data++ = value.IsNull() ? 1 : 0;
+    if (!value.IsNull()) {
+      data += value.SerializeTo(data);
+    }
+  }
+  buffer_end_ += sizeof(size) + size;
+  size_ += sizeof(size) + size;
+  record_count_++;
+}
+
+void TempFile::Rewind() {
+  if (!reading_) {
+    FlushBuffer();
+    reading_ = true;
+  }
+  file_offset_ = 0;
+  buffer_begin_ = 0;
+  buffer_end_ = 0;
+}
+
+std::shared_ptr<Record> TempFile::Next() {
+  uint32_t size;
+  if (!FillBuffer(sizeof(size))) {
+    return nullptr;
+  }
+  memcpy(&size, buffer_.data() + buffer_begin_, sizeof(size));
+  if (!FillBuffer(sizeof(size) + size)) {
+    throw DbException("Temp file truncated");
+  }
+  const char *data = buffer_.data() + buffer_begin_ + sizeof(size);
+  uint16_t value_count;
+  memcpy(&value_count, data, sizeof(value_count));
+  data += sizeof(value_count);
+  std::vector<Value> values;
+  values.reserve(value_count);
+  for (uint16_t i = 0; i < value_count; i++) {
+    auto type = static_cast<Type>(*data++);
+    bool is_null = *data++ != 0;
+    if (is_null) {
+      values.emplace_back(type, 0);
+      continue;
+    }
+    auto &value = values.emplace_back(type, TypeUtil::IsString(type) ? 0 : TypeUtil::TypeSize(type));
+    data += value.DeserializeFrom(data);
+  }
+  buffer_begin_ += sizeof(size) + size;
+  return std::make_shared<Record>(std::move(values));
+}
+
+size_t TempFile::GetRecordCount() const { return record_count_; }
+
+size_t TempFile::GetSize() const { return size_; }
+
+void TempFile::FlushBuffer() {
+  size_t written = 0;
+  while (written < buffer_end_) {
+    auto bytes = pwrite(fd_, buffer_.data() + written, buffer_end_ - written, file_offset_ + written);
+    if (bytes < 0) {
+      throw DbException(std::string("Write temp file failed: ") + std::strerror(errno));
+    }
+    written += bytes;
+  }
+  file_offset_ += buffer_end_;
+  buffer_end_ = 0;
+}
+
+bool TempFile::FillBuffer(size_t size) {
+  if (buffer_end_ - buffer_begin_ >= size) {
+    return true;
+  }
+  // 将未读的内容移到缓冲区开头，再从文件读入
+  memmove(buffer_.data(), buffer_.data() + buffer_begin_, buffer_end_ - buffer_begin_);
+  buffer_end_ -= buffer_begin_;
+  buffer_begin_ = 0;
+  if (size > buffer_.size()) {
+    buffer_.resize(size);
+  }
+  while (buffer_end_ < size) {
+    auto bytes = pread(fd_, buffer_.data() + buffer_end_, buffer_.size() - buffer_end_, file_offset_);
+    if (bytes < 0) {
+      throw DbException(std::string("Read temp file failed: ") + std::strerror(errno));
+    }
+    if (bytes == 0) {
+      return false;
+    }
+    buffer_end_ += bytes;
+    file_offset_ += bytes;
+  }
+  return true;
+}
+
+}  // namespace huadb
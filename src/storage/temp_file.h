@@ -0,0 +1,55 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "table/record.h"
+
+namespace huadb {
+
+// 查询执行时溢出到磁盘的临时文件，记录按追加方式写入，写完后从头顺序读出
+// 文件位于临时数据库目录下，创建后立即删除目录项，关闭描述符后空间自动回收，故障重启后也不会残留
+// 每个值带有类型与空值标记，读出时无需 schema。非线程安全
+class TempFile {
+ public:
+  TempFile();
+  ~TempFile();
+
+  TempFile(const TempFile &) = delete;
+  TempFile &operator=(const TempFile &) = delete;
+
+  void Append(const Record &record);
+
+  // 结束写入，从头开始读取。可多次调用以重复读取
+  void Rewind();
+
+  // 读出下一条记录，读完时返回空指针
+  std::shared_ptr<Record> Next();
+
+  size_t GetRecordCount() const;
+
+  // 已写入的字节数
+  size_t GetSize() const;
+
+ private:
+  static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+  // 将写缓冲区中的内容写入文件
+  void FlushBuffer();
+
+  // 使读缓冲区中至少有 size 字节未读的内容，文件中剩余内容不足时返回 false
+  bool FillBuffer(size_t size);
+
+  int fd_;
+  std::vector<char> buffer_;
+  size_t buffer_begin_ = 0;  // 读取时缓冲区中下一个未读字节的位置
+  size_t buffer_end_ = 0;    // 缓冲区中有效内容的末尾
+  off_t file_offset_ = 0;    // 写入时为缓冲区内容在文件中的起始位置，读取时为下一次读入缓冲区的位置
+  size_t size_ = 0;
+  size_t record_count_ = 0;
+  bool reading_ = false;
+};
+
+}  // namespace huadb
@@ -0,0 +1,72 @@
+#include "storage/thread_pool_io_backend.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace huadb {
+
+ThreadPoolIOBackend::ThreadPoolIOBackend(size_t workers) {
+  for (size_t i = 0; i < workers; i++) {
+    workers_.emplace_back(&ThreadPoolIOBackend::WorkerLoop, this);
+  }
+}
+
+ThreadPoolIOBackend::~ThreadPoolIOBackend() {
+  {
+    std::unique_lock lock(queue_mutex_);
+    stop_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPoolIOBackend::Submit(std::vector<IORequest> &requests) {
+  if (requests.empty()) {
+    return;
+  }
+  Batch batch;
+  batch.remaining_ = requests.size();
+  {
+    std::unique_lock lock(queue_mutex_);
+    for (auto &request : requests) {
+      queue_.emplace_back(&request, &batch);
+    }
+  }
+  queue_cv_.notify_all();
+  std::unique_lock lock(batch.mutex_);
+  batch.cv_.wait(lock, [&batch] { return batch.remaining_ == 0; });
+}
+
+void ThreadPoolIOBackend::WorkerLoop() {
+  while (true) {
+    std::pair<IORequest *, Batch *> task;
+    {
+      std::unique_lock lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      task = queue_.front();
+      queue_.pop_front();
+    }
+    auto &[request, batch] = task;
+    if (request->write_) {
+      request->result_ = pwrite(request->fd_, request->data_, request->size_, request->offset_);
+    } else {
+      request->result_ = pread(request->fd_, request->data_, request->size_, request->offset_);
+    }
+    if (request->result_ < 0) {
+      request->result_ = -errno;
+    }
+    // 在锁内通知，避免 Submit 返回后 batch 已销毁
+    std::unique_lock lock(batch->mutex_);
+    if (--batch->remaining_ == 0) {
+      batch->cv_.notify_one();
+    }
+  }
+}
+
+}  // namespace huadb
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "storage/io_backend.h"
+
+namespace huadb {
+
+// 线程池 I/O 后端：批内请求分发给固定数量的工作线程，以 pread/pwrite 并发执行
+class ThreadPoolIOBackend : public IOBackend {
+ public:
+  explicit ThreadPoolIOBackend(size_t workers);
+  ~ThreadPoolIOBackend() override;
+  void Submit(std::vector<IORequest> &requests) override;
+
+ private:
+  // 一次 Submit 调用的完成情况
+  struct Batch {
+    size_t remaining_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+  };
+
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::pair<IORequest *, Batch *>> queue_;  // 待执行的请求
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  bool stop_ = false;
+};
+
+}  // namespace huadb
@@ -0,0 +1,63 @@
+#include "storage/two_queue_buffer_strategy.h"
+
+#include <algorithm>
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+TwoQueueBufferStrategy::TwoQueueBufferStrategy(size_t buffer_size)
+    : a1_(buffer_size), am_(buffer_size), a1_max_size_(std::max<size_t>(1, buffer_size / 4)) {}
+
+void TwoQueueBufferStrategy::Access(size_t frame_no) {
+  if (am_.Contains(frame_no)) {
+    am_.Remove(frame_no);
+    am_.PushFront(frame_no);
+  } else if (a1_.Contains(frame_no)) {
+    if (frame_no != last_frame_) {
+      a1_.Remove(frame_no);
+      am_.PushFront(frame_no);
+    }
+  } else {
+    a1_.PushFront(frame_no);
+  }
+  last_frame_ = frame_no;
+}
+
+size_t TwoQueueBufferStrategy::Evict() {
+  size_t frame_no;
+  if (!a1_.Empty() && (a1_.Size() > a1_max_size_ || am_.Empty())) {
+    frame_no = a1_.Back();
+    a1_.Remove(frame_no);
+  } else if (!am_.Empty()) {
+    frame_no = am_.Back();
+    am_.Remove(frame_no);
+  } else {
+    throw DbException("No frame to evict in TwoQueueBufferStrategy");
+  }
+  if (last_frame_ == frame_no) {
+    last_frame_ = NULL_FRAME_ID;
+  }
+  return frame_no;
+}
+
+std::vector<size_t> TwoQueueBufferStrategy::GetEvictionCandidates(size_t count) const {
+  // 先是 a1 中超出目标容量的部分，然后是 am，最后是 a1 的剩余部分
+  std::vector<size_t> candidates;
+  auto a1_frame = a1_.Back();
+  for (size_t a1_excess = a1_.Size() > a1_max_size_ ? a1_.Size() - a1_max_size_ : 0;
+       a1_excess > 0 && candidates.size() < count; a1_excess--) {
+    candidates.push_back(a1_frame);
+    a1_frame = a1_.Prev(a1_frame);
+  }
+  for (auto frame_no = am_.Back(); frame_no != NULL_FRAME_ID && candidates.size() < count;
+       frame_no = am_.Prev(frame_no)) {
+    candidates.push_back(frame_no);
+  }
+  for (; a1_frame != NULL_FRAME_ID && candidates.size() < count; a1_frame = a1_.Prev(a1_frame)) {
+    candidates.push_back(a1_frame);
+  }
+  return candidates;
+}
+
+}  // namespace huadb
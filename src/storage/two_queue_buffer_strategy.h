@@ -0,0 +1,25 @@
+#pragma once
+
+#include "storage/buffer_strategy.h"
+#include "storage/frame_list.h"
+
+namespace huadb {
+
+// 2Q 替换策略（简化版）：首次载入的帧进入 FIFO 队列 a1，再次访问时晋升到 LRU 队列 am
+// a1 超过容量的 1/4 时优先从 a1 淘汰，因此只访问一次的顺序扫描页面不会挤出 am 中的热点页面
+// 对同一帧的连续访问视为相关访问，不会触发晋升
+class TwoQueueBufferStrategy : public BufferStrategy {
+ public:
+  explicit TwoQueueBufferStrategy(size_t buffer_size);
+  void Access(size_t frame_no) override;
+  size_t Evict() override;
+  std::vector<size_t> GetEvictionCandidates(size_t count) const override;
+
+ private:
+  FrameList a1_;
+  FrameList am_;
+  size_t a1_max_size_;
+  size_t last_frame_ = NULL_FRAME_ID;
+};
+
+}  // namespace huadb
@@ -0,0 +1,81 @@
+#include "table/free_space_map.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "common/constants.h"
+
+namespace huadb {
+
+void FreeSpaceMap::Update(pageid_t page_id, db_size_t free_space) {
+  if (page_id >= capacity_) {
+    Reserve(static_cast<size_t>(page_id) + 1);
+  }
+  page_count_ = std::max<pageid_t>(page_count_, page_id + 1);
+  size_t node = capacity_ + page_id;
+  tree_[node] = free_space;
+  for (node /= 2; node > 0; node /= 2) {
+    tree_[node] = std::max(tree_[node * 2], tree_[node * 2 + 1]);
+  }
+}
+
+pageid_t FreeSpaceMap::Search(db_size_t size) const {
+  if (capacity_ == 0 || tree_[1] < size) {
+    return NULL_PAGE_ID;
+  }
+  size_t node = 1;
+  while (node < capacity_) {
+    node = tree_[node * 2] >= size ? node * 2 : node * 2 + 1;
+  }
+  return node - capacity_;
+}
+
+pageid_t FreeSpaceMap::GetPageCount() const { return page_count_; }
+
+void FreeSpaceMap::Truncate(pageid_t page_count) {
+  for (pageid_t page_id = page_count; page_id < page_count_; page_id++) {
+    Update(page_id, 0);
+  }
+  page_count_ = std::min(page_count_, page_count);
+}
+
+void FreeSpaceMap::Load(const std::string &path, pageid_t max_pages) {
+  page_count_ = 0;
+  capacity_ = 0;
+  tree_.clear();
+  std::ifstream in(path, std::ifstream::binary);
+  pageid_t page_count;
+  if (!in.read(reinterpret_cast<char *>(&page_count), sizeof(page_count))) {
+    return;
+  }
+  page_count = std::min(page_count, max_pages);
+  std::vector<db_size_t> free_spaces(page_count);
+  if (!in.read(reinterpret_cast<char *>(free_spaces.data()), page_count * sizeof(db_size_t))) {
+    return;
+  }
+  for (pageid_t page_id = 0; page_id < page_count; page_id++) {
+    Update(page_id, free_spaces[page_id]);
+  }
+}
+
+void FreeSpaceMap::Save(const std::string &path) const {
+  std::ofstream out(path, std::ofstream::binary | std::ofstream::trunc);
+  out.write(reinterpret_cast<const char *>(&page_count_), sizeof(page_count_));
+  out.write(reinterpret_cast<const char *>(tree_.data() + capacity_), page_count_ * sizeof(db_size_t));
+}
+
+void FreeSpaceMap::Reserve(size_t capacity) {
+  size_t new_capacity = std::max<size_t>(capacity_, 1);
+  while (new_capacity < capacity) {
+    new_capacity *= 2;
+  }
+  std::vector<db_size_t> new_tree(new_capacity * 2, 0);
+  std::copy(tree_.begin() + capacity_, tree_.begin() + capacity_ + page_count_, new_tree.begin() + new_capacity);
+  for (size_t node = new_capacity - 1; node > 0; node--) {
+    new_tree[node] = std::max(new_tree[node * 2], new_tree[node * 2 + 1]);
+  }
+  capacity_ = new_capacity;
+  tree_ = std::move(new_tree);
+}
+
+}  // namespace huadb
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+
+namespace huadb {
+
+// 空闲空间映射：记录表中每个页面的空闲字节数，用最大值线段树在 O(log N) 内找到可以容纳记录的页面
+// 映射只是提示，可能落后于页面的实际状态，使用者需以页面中的空闲空间为准并及时更新
+// 非线程安全，由 Table 加锁保护
+class FreeSpaceMap {
+ public:
+  // 记录页面的空闲空间，页面号超出已记录范围时扩展，中间未记录的页面视为没有空闲空间
+  void Update(pageid_t page_id, db_size_t free_space);
+
+  // 查找页面号最小的、空闲空间不小于 size 的页面，不存在时返回 NULL_PAGE_ID
+  pageid_t Search(db_size_t size) const;
+
+  // 已记录的页面数
+  pageid_t GetPageCount() const;
+
+  // 表文件被截断，丢弃页面号不小于 page_count 的页面的记录
+  void Truncate(pageid_t page_count);
+
+  // 从文件载入，只保留前 max_pages 个页面的记录。文件不存在或格式不符时映射为空
+  void Load(const std::string &path, pageid_t max_pages);
+
+  void Save(const std::string &path) const;
+
+ private:
+  // 扩展叶子数，使其不小于 capacity
+  void Reserve(size_t capacity);
+
+  pageid_t page_count_ = 0;
+  size_t capacity_ = 0;          // 叶子数，为 2 的幂
+  std::vector<db_size_t> tree_;  // 下标从 1 开始，tree_[capacity_ + i] 为页面 i 的空闲空间
+};
+
+}  // namespace huadb
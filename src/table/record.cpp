@@ -1,8 +1,10 @@
 #include "table/record.h"
 
 #include <cassert>
+#include <cstring>
 
 #include "common/exceptions.h"
+#include "table/toast.h"
 
 namespace huadb {
 
@@ -48,6 +50,16 @@ namespace huadb {
 
     const std::vector<Value> &Record::GetValues() const { return values_; }
 
+    void Record::SetToastPointer(size_t col_idx, const std::string &pointer) {
+        toasted_.resize(values_.size());
+        toasted_[col_idx] = true;
+        values_[col_idx] = Value(pointer, values_[col_idx].GetType());
+        null_bitmap_.Clear(col_idx);
+        UpdateSize();
+    }
+
+    bool Record::IsToasted(size_t col_idx) const { return col_idx < toasted_.size() && toasted_[col_idx]; }
+
     db_size_t Record::GetSize() const { return size_; }
 
     std::string Record::ToString() const {
@@ -62,32 +74,59 @@ namespace huadb {
     db_size_t Record::SerializeTo(char *data) const {
         auto offset = header_.SerializeTo(data);
         offset += null_bitmap_.SerializeTo(data + offset);
+        // 定长列在前、变长列在后，使定长列的偏移不依赖变长列的长度
         for (const auto &value: values_) {
-            if (value.IsNull()) {
+            if (!value.IsNull() && !TypeUtil::IsString(value.GetType())) {
+                offset += value.SerializeTo(data + offset);
+            }
+        }
+        for (size_t i = 0; i < values_.size(); i++) {
+            if (values_[i].IsNull() || !TypeUtil::IsString(values_[i].GetType())) {
                 continue;
             }
-            offset += value.SerializeTo(data + offset);
+            if (IsToasted(i)) {
+                db_size_t size = values_[i].GetSize() | TOAST_LENGTH_FLAG;
+                memcpy(data + offset, &size, sizeof(size));
+                offset += sizeof(size);
+                memcpy(data + offset, values_[i].GetValue<std::string_view>().data(), values_[i].GetSize());
+                offset += values_[i].GetSize();
+            } else {
+                offset += values_[i].SerializeTo(data + offset);
+            }
         }
         assert(offset == GetSize());
         return offset;
     }
 
-    db_size_t Record::DeserializeFrom(const char *data, const ColumnList &column_list) {
+    db_size_t Record::DeserializeFrom(const char *data, const ColumnList &column_list, const ToastRelation *toast) {
         auto offset = header_.DeserializeFrom(data);
         null_bitmap_.Resize(column_list.Length());
         offset += null_bitmap_.DeserializeFrom(data + offset);
-        auto columns = column_list.GetColumns();
-        for (size_t i = 0; i < columns.size(); i++) {
-            if (null_bitmap_.Test(i)) {
-                values_.push_back(Value());
-            } else {
-                auto value = Value(columns[i].type_, columns[i].max_size_);
-                offset += value.DeserializeFrom(data + offset);
-                values_.push_back(value);
+        const auto &columns = column_list.GetColumns();
+        values_.resize(columns.size());
+        for (const auto &order: {&column_list.GetFixedColumns(), &column_list.GetVarlenColumns()}) {
+            for (auto i: *order) {
+                if (null_bitmap_.Test(i)) {
+                    continue;
+                }
+                db_size_t size = 0;
+                if (TypeUtil::IsString(columns[i].type_)) {
+                    memcpy(&size, data + offset, sizeof(size));
+                }
+                if (size & TOAST_LENGTH_FLAG) {
+                    // 反序列化得到的记录只保存字段的值，记录大小按读出的值计算
+                    if (toast == nullptr) {
+                        throw DbException("Toasted column without toast relation");
+                    }
+                    values_[i] = toast->Detoast(data + offset + sizeof(size), columns[i].type_);
+                    offset += sizeof(size) + (size & ~TOAST_LENGTH_FLAG);
+                } else {
+                    values_[i] = Value(columns[i].type_, columns[i].max_size_);
+                    offset += values_[i].DeserializeFrom(data + offset);
+                }
             }
         }
         UpdateSize();
-        assert(offset == GetSize());
         return offset;
     }
 
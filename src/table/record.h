@@ -10,6 +10,8 @@
 
 namespace huadb {
 
+    class ToastRelation;
+
     class Record {
     public:
         Record() = default;
@@ -28,6 +30,12 @@ namespace huadb {
         // 获取所有 column 的值
         const std::vector<Value> &GetValues() const;
 
+        // 将第 col_idx 个 column 替换为 TOAST 指针，序列化时长度带有 TOAST_LENGTH_FLAG 标记
+        void SetToastPointer(size_t col_idx, const std::string &pointer);
+
+        // 第 col_idx 个 column 是否为 TOAST 指针
+        bool IsToasted(size_t col_idx) const;
+
         // 获取记录的大小
         db_size_t GetSize() const;
 
@@ -37,8 +45,9 @@ namespace huadb {
         // 记录序列化
         db_size_t SerializeTo(char *data) const;
 
-        // 记录反序列化
-        db_size_t DeserializeFrom(const char *data, const ColumnList &column_list);
+        // 记录反序列化，存放在 TOAST 关系中的字段从 toast 中读出
+        db_size_t DeserializeFrom(const char *data, const ColumnList &column_list,
+                                  const ToastRelation *toast = nullptr);
 
         // 记录头序列化
         void SerializeHeaderTo(char *data) const;
@@ -76,6 +85,8 @@ namespace huadb {
         // 空值位图
         Bitmap null_bitmap_;
         std::vector<Value> values_;
+        // 各 column 是否为 TOAST 指针，为空表示均不是
+        std::vector<bool> toasted_;
         RecordHeader header_;
         Rid rid_;
         db_size_t size_;
@@ -1,7 +1,6 @@
 #include <iostream>
 #include "common/types.h"
 #include "table/table.h"
-#include "table/table_page.h"
 
 namespace huadb {
 
@@ -14,14 +13,37 @@ namespace huadb {
               column_list_(std::move(column_list)) {
         if (new_table || is_empty) {
             first_page_id_ = NULL_PAGE_ID;
+            last_page_id_ = NULL_PAGE_ID;
         } else {
             first_page_id_ = 0;
+            // 映射可能比表文件新（如故障前保存），只保留已写入磁盘的页面，其余页面插入时沿链表找到
+            auto path = Disk::GetFilePath(db_oid_, oid_);
+            pageid_t page_count = Disk::FileSize(path) / buffer_pool_.GetPageSize();
+            fsm_.Load(Disk::GetFsmPath(db_oid_, oid_), page_count);
+            last_page_id_ = page_count > 0 ? page_count - 1 : 0;
+        }
+        if (oid_ > PRESERVED_OID && !IsToastOid(oid_)) {
+            toast_ = std::make_unique<ToastRelation>(buffer_pool_, log_manager_, oid_, db_oid_);
         }
     }
 
-    Rid Table::InsertRecord(const std::shared_ptr<Record> &record, xid_t xid, cid_t cid, bool write_log) {
-        if (record->GetSize() > MAX_RECORD_SIZE) {
-            throw DbException("Record size too large: " + std::to_string(record->GetSize()));
+    Table::~Table() = default;
+
+    void Table::SaveFreeSpaceMap() {
+        std::unique_lock lock(fsm_mutex_);
+        if (fsm_.GetPageCount() > 0) {
+            fsm_.Save(Disk::GetFsmPath(db_oid_, oid_));
+        }
+        lock.unlock();
+        if (toast_ != nullptr) {
+            toast_->SaveFreeSpaceMap();
+        }
+    }
+
+    Rid Table::InsertRecord(const std::shared_ptr<Record> &record, xid_t xid, cid_t cid, bool write_log,
+                            xid_t oldest_xid) {
+        if (record->GetSize() > GetMaxRecordSize(buffer_pool_.GetPageSize())) {
+            return InsertRecord(ToastRecord(record, xid, cid, write_log, oldest_xid), xid, cid, write_log, oldest_xid);
         }
         // 当 write_log 参数为 true 时开启写日志功能
         // 在插入记录时增加写 InsertLog 过程
@@ -32,97 +54,481 @@ namespace huadb {
         slotid_t slot_id = 0;
 
         if (first_page_id_ == NULL_PAGE_ID) {
-            first_page_id_ = 0;
-            auto first_page = buffer_pool_.NewPage(db_oid_, oid_, first_page_id_);
-            TablePage first_table_page(first_page);
-            first_table_page.Init();
-            slot_id = first_table_page.InsertRecord(record, xid, cid);
+            // 空表插入时加锁，避免并发插入同时创建第一个页面
+            std::unique_lock first_page_lock(first_page_mutex_);
+            if (first_page_id_ == NULL_PAGE_ID) {
+                auto first_page = buffer_pool_.NewPage(db_oid_, oid_, 0);
+                std::unique_lock latch(first_page->GetLatch());
+                first_page_id_ = 0;
+                last_page_id_ = 0;
+                TablePage first_table_page(first_page);
+                first_table_page.Init();
+                slot_id = first_table_page.InsertRecord(record, xid, cid);
 
-            if (write_log) {
-                // 这里offset为插入record后的upper指针， 即指向当前记录的头部
-                db_size_t offset = first_table_page.GetUpper();
-                char *new_record = first_table_page.GetPageData() + offset;
+                if (write_log) {
+                    // 这里offset为插入record后的upper指针， 即指向当前记录的头部
+                    db_size_t offset = first_table_page.GetUpper();
+                    char *new_record = first_table_page.GetPageData() + offset;
 
-                log_manager_.AppendNewPageLog(xid, oid_, NULL_PAGE_ID, first_page_id_);
-                auto lsn = log_manager_.AppendInsertLog(xid, oid_, first_page_id_, slot_id, offset, record->GetSize(),
-                                                        new_record);
-                first_table_page.SetPageLSN(lsn);
+                    log_manager_.AppendNewPageLog(xid, oid_, NULL_PAGE_ID, 0);
+                    auto lsn = log_manager_.AppendInsertLog(xid, oid_, 0, slot_id, offset, record->GetSize(), new_record);
+                    first_table_page.SetPageLSN(lsn);
+                }
+                UpdateFreeSpace(0, first_table_page.GetFreeSpaceSize());
+                return {0, slot_id};
             }
+        }
 
-        } else {
-            while (current_page_id != NULL_PAGE_ID) {
-                auto current_page = buffer_pool_.GetPage(db_oid_, oid_, current_page_id);
-                TablePage table_page(current_page);
-
-                if (table_page.GetFreeSpaceSize() >= record->GetSize()) {
-                    slot_id = table_page.InsertRecord(record, xid, cid);
-
-                    if (write_log) {
-                        db_size_t offset = table_page.GetUpper();
-                        char *new_record = table_page.GetPageData() + offset;
-                        auto lsn = log_manager_.AppendInsertLog(xid, oid_, current_page_id, slot_id, offset,
-                                                                record->GetSize(), new_record);
-                        table_page.SetPageLSN(lsn);
-                    }
+        current_page_id = FindPageWithSpace(record->GetSize(), oldest_xid, write_log);
+        while (true) {
+            auto current_page = buffer_pool_.GetPage(db_oid_, oid_, current_page_id);
+            // 持有当前页面的排他锁直到插入完成或确定下一个页面，避免并发插入同时扩展表
+            std::unique_lock latch(current_page->GetLatch());
+            TablePage table_page(current_page);
+
+            if (table_page.GetFreeSpaceSize() >= record->GetSize()) {
+                slot_id = table_page.InsertRecord(record, xid, cid);
+                ClearAllVisible(current_page_id);
 
-                    break;
+                if (write_log) {
+                    db_size_t offset = table_page.GetUpper();
+                    char *new_record = table_page.GetPageData() + offset;
+                    auto lsn = log_manager_.AppendInsertLog(xid, oid_, current_page_id, slot_id, offset,
+                                                            record->GetSize(), new_record);
+                    table_page.SetPageLSN(lsn);
                 }
-                // 无可用表
-                if (table_page.GetNextPageId() == NULL_PAGE_ID) {
-                    auto new_page = buffer_pool_.NewPage(db_oid_, oid_, current_page_id + 1);
-                    TablePage new_table_page(new_page);
-                    new_table_page.Init();
-                    table_page.SetNextPageId(current_page_id + 1);
-                    slot_id = new_table_page.InsertRecord(record, xid, cid);
-
-                    if (write_log) {
-                        db_size_t offset = new_table_page.GetUpper();
-                        char *new_record = new_table_page.GetPageData() + offset;
-                        log_manager_.AppendNewPageLog(xid, oid_, current_page_id, current_page_id + 1);
-                        auto lsn = log_manager_.AppendInsertLog(xid, oid_, current_page_id + 1, slot_id, offset,
-                                                                record->GetSize(), new_record);
-                        new_table_page.SetPageLSN(lsn);
-                    }
+                UpdateFreeSpace(current_page_id, table_page.GetFreeSpaceSize());
+                return {current_page_id, slot_id};
+            }
+            UpdateFreeSpace(current_page_id, table_page.GetFreeSpaceSize());
+            // 无可用表
+            if (table_page.GetNextPageId() == NULL_PAGE_ID) {
+                pageid_t new_page_id = current_page_id + 1;
+                auto new_page = buffer_pool_.NewPage(db_oid_, oid_, new_page_id);
+                std::unique_lock new_page_latch(new_page->GetLatch());
+                TablePage new_table_page(new_page);
+                new_table_page.Init();
+                table_page.SetNextPageId(new_page_id);
+                ClearAllVisible(current_page_id);
+                last_page_id_ = new_page_id;
+                slot_id = new_table_page.InsertRecord(record, xid, cid);
 
-                    break;
+                if (write_log) {
+                    db_size_t offset = new_table_page.GetUpper();
+                    char *new_record = new_table_page.GetPageData() + offset;
+                    log_manager_.AppendNewPageLog(xid, oid_, current_page_id, new_page_id);
+                    auto lsn = log_manager_.AppendInsertLog(xid, oid_, new_page_id, slot_id, offset,
+                                                            record->GetSize(), new_record);
+                    new_table_page.SetPageLSN(lsn);
                 }
+                UpdateFreeSpace(new_page_id, new_table_page.GetFreeSpaceSize());
+                return {new_page_id, slot_id};
+            }
+            // 映射记录的空闲空间已过期时重新查找，映射中没有合适页面时沿链表前进
+            {
+                std::unique_lock lock(fsm_mutex_);
+                current_page_id = fsm_.Search(record->GetSize());
+            }
+            if (current_page_id == NULL_PAGE_ID) {
                 current_page_id = table_page.GetNextPageId();
             }
         }
-        return {current_page_id, slot_id};
+    }
+
+    std::vector<Rid> Table::InsertRecords(const std::vector<std::shared_ptr<Record>> &records, xid_t xid, cid_t cid,
+                                          bool write_log, xid_t oldest_xid) {
+        std::vector<std::shared_ptr<Record>> toasted_records;
+        for (size_t i = 0; i < records.size(); i++) {
+            if (records[i]->GetSize() > GetMaxRecordSize(buffer_pool_.GetPageSize())) {
+                if (toasted_records.empty()) {
+                    toasted_records = records;
+                }
+                toasted_records[i] = ToastRecord(records[i], xid, cid, write_log, oldest_xid);
+            }
+        }
+        if (!toasted_records.empty()) {
+            return InsertRecords(toasted_records, xid, cid, write_log, oldest_xid);
+        }
+        std::vector<Rid> rids;
+        rids.reserve(records.size());
+        if (records.empty()) {
+            return rids;
+        }
+        size_t next = 0;
+        // 空表由单条插入创建第一个页面
+        if (first_page_id_ == NULL_PAGE_ID) {
+            rids.push_back(InsertRecord(records[0], xid, cid, write_log, oldest_xid));
+            next = 1;
+            if (next == records.size()) {
+                return rids;
+            }
+        }
+
+        pageid_t page_id = FindPageWithSpace(records[next]->GetSize(), oldest_xid, write_log);
+        auto page = buffer_pool_.GetPage(db_oid_, oid_, page_id);
+        std::unique_lock latch(page->GetLatch());
+        TablePage table_page(page);
+        while (true) {
+            next = FillPage(table_page, page_id, records, next, xid, cid, write_log, rids);
+            if (next == records.size()) {
+                return rids;
+            }
+            pageid_t next_page_id = table_page.GetNextPageId();
+            if (next_page_id == NULL_PAGE_ID) {
+                // 持有末尾页面的锁扩展新页面，新页面保持固定直到填满
+                next_page_id = page_id + 1;
+                auto new_page = buffer_pool_.NewPage(db_oid_, oid_, next_page_id);
+                std::unique_lock new_page_latch(new_page->GetLatch());
+                TablePage new_table_page(new_page);
+                new_table_page.Init();
+                table_page.SetNextPageId(next_page_id);
+                ClearAllVisible(page_id);
+                last_page_id_ = next_page_id;
+                if (write_log) {
+                    log_manager_.AppendNewPageLog(xid, oid_, page_id, next_page_id);
+                }
+                page = std::move(new_page);
+                latch = std::move(new_page_latch);
+                table_page = new_table_page;
+                page_id = next_page_id;
+                continue;
+            }
+            // 当前页面不是末尾页面，按映射重新查找，映射中没有合适页面时沿链表前进
+            latch.unlock();
+            {
+                std::unique_lock lock(fsm_mutex_);
+                page_id = fsm_.Search(records[next]->GetSize());
+            }
+            if (page_id == NULL_PAGE_ID) {
+                page_id = PruneForSpace(records[next]->GetSize(), oldest_xid, write_log);
+            }
+            if (page_id == NULL_PAGE_ID) {
+                page_id = next_page_id;
+            }
+            page = buffer_pool_.GetPage(db_oid_, oid_, page_id);
+            latch = std::unique_lock(page->GetLatch());
+            table_page = TablePage(page);
+        }
+    }
+
+    size_t Table::FillPage(TablePage &table_page, pageid_t page_id, const std::vector<std::shared_ptr<Record>> &records,
+                           size_t next, xid_t xid, cid_t cid, bool write_log, std::vector<Rid> &rids) {
+        slotid_t first_slot_id = table_page.GetRecordCount();
+        db_size_t old_upper = table_page.GetUpper();
+        size_t count = 0;
+        while (next + count < records.size() && table_page.GetFreeSpaceSize() >= records[next + count]->GetSize()) {
+            // 批量插入的槽位连续分配，不复用空出的槽位
+            auto slot_id = table_page.InsertRecord(records[next + count], xid, cid, false);
+            rids.push_back({page_id, slot_id});
+            count++;
+        }
+        if (count > 0) {
+            ClearAllVisible(page_id);
+        }
+        if (count > 0 && write_log) {
+            db_size_t upper = table_page.GetUpper();
+            char *page_data = table_page.GetPageData();
+            lsn_t lsn;
+            if (count == 1) {
+                lsn = log_manager_.AppendInsertLog(xid, oid_, page_id, first_slot_id, upper,
+                                                   records[next]->GetSize(), page_data + upper);
+            } else {
+                // 本页新插入的记录在页面中连续存放，整体写入一条日志
+                std::vector<Slot> slots;
+                slots.reserve(count);
+                for (size_t i = 0; i < count; i++) {
+                    slots.push_back(table_page.GetSlot(first_slot_id + i));
+                }
+                lsn = log_manager_.AppendBulkInsertLog(xid, oid_, page_id, first_slot_id, std::move(slots), upper,
+                                                       std::vector<char>(page_data + upper, page_data + old_upper));
+            }
+            table_page.SetPageLSN(lsn);
+        }
+        UpdateFreeSpace(page_id, table_page.GetFreeSpaceSize());
+        return next + count;
     }
 
     void Table::DeleteRecord(const Rid &rid, xid_t xid, bool write_log) {
         // 增加写 DeleteLog 过程
         // 设置页面的 page lsn
         auto page = buffer_pool_.GetPage(db_oid_, oid_, rid.page_id_);
+        std::unique_lock latch(page->GetLatch());
         TablePage table_page(page);
         table_page.DeleteRecord(rid.slot_id_, xid);
+        ClearAllVisible(rid.page_id_);
 
         if (write_log) {
             auto lsn = log_manager_.AppendDeleteLog(xid, oid_, rid.page_id_, rid.slot_id_);
             table_page.SetPageLSN(lsn);
         }
+        AddDeadTuple(rid.page_id_, xid);
+        DeleteToastValues(table_page, rid, xid, write_log);
     }
 
     Rid
-    Table::UpdateRecord(const Rid &rid, xid_t xid, cid_t cid, const std::shared_ptr<Record> &record, bool write_log) {
+    Table::UpdateRecord(const Rid &rid, xid_t xid, cid_t cid, const std::shared_ptr<Record> &record, bool write_log,
+                        xid_t oldest_xid) {
+        if (record->GetSize() > GetMaxRecordSize(buffer_pool_.GetPageSize())) {
+            return UpdateRecord(rid, xid, cid, ToastRecord(record, xid, cid, write_log, oldest_xid), write_log,
+                                oldest_xid);
+        }
+        {
+            auto page = buffer_pool_.GetPage(db_oid_, oid_, rid.page_id_);
+            std::unique_lock latch(page->GetLatch());
+            TablePage table_page(page);
+            // 旧版本所在页面空间不足时，先回收页面中已删除的记录
+            if (table_page.GetFreeSpaceSize() < record->GetSize() && oldest_xid != DDL_XID) {
+                PrunePage(table_page, rid.page_id_, oldest_xid, write_log);
+            }
+            if (table_page.GetFreeSpaceSize() >= record->GetSize()) {
+                // 新版本放入旧版本所在页面，只修改一个页面、写一条 UpdateLog
+                table_page.DeleteRecord(rid.slot_id_, xid);
+                auto slot_id = table_page.InsertRecord(record, xid, cid);
+                ClearAllVisible(rid.page_id_);
+                if (write_log) {
+                    db_size_t offset = table_page.GetUpper();
+                    auto lsn = log_manager_.AppendUpdateLog(xid, oid_, rid.page_id_, rid.slot_id_, slot_id, offset,
+                                                            record->GetSize(), table_page.GetPageData() + offset);
+                    table_page.SetPageLSN(lsn);
+                }
+                UpdateFreeSpace(rid.page_id_, table_page.GetFreeSpaceSize());
+                AddDeadTuple(rid.page_id_, xid);
+                DeleteToastValues(table_page, rid, xid, write_log);
+                return {rid.page_id_, slot_id};
+            }
+        }
         DeleteRecord(rid, xid, write_log);
-        return InsertRecord(record, xid, cid, write_log);
+        return InsertRecord(record, xid, cid, write_log, oldest_xid);
     }
 
     void Table::UpdateRecordInPlace(const Record &record) {
         auto rid = record.GetRid();
-        auto table_page = std::make_unique<TablePage>(buffer_pool_.GetPage(db_oid_, oid_, rid.page_id_));
-        table_page->UpdateRecordInPlace(record, rid.slot_id_);
+        auto page = buffer_pool_.GetPage(db_oid_, oid_, rid.page_id_);
+        std::unique_lock latch(page->GetLatch());
+        TablePage table_page(page);
+        table_page.UpdateRecordInPlace(record, rid.slot_id_);
     }
 
+    uint32_t Table::Vacuum(xid_t oldest_xid) {
+        uint32_t live_count = 0;
+        // 与顺序扫描相同，大表使用环形缓冲区，避免清理冲掉缓存中的热点页面
+        auto strategy = buffer_pool_.CreateScanStrategy(db_oid_, oid_);
+        auto page_id = first_page_id_.load();
+        // 表末尾连续的空页面中的第一个，第一个页面总是保留
+        pageid_t truncate_from = NULL_PAGE_ID;
+        while (page_id != NULL_PAGE_ID) {
+            {
+                // 全可见页面中没有可回收的记录，记录数与下一个页面在标记后也未变化，无需读取页面
+                std::unique_lock lock(vm_mutex_);
+                if (vm_.IsAllVisible(page_id)) {
+                    live_count += vm_.GetRecordCount(page_id);
+                    // 全可见页面中没有删除记录，记录数为 0 时页面为空
+                    if (vm_.GetRecordCount(page_id) > 0) {
+                        truncate_from = NULL_PAGE_ID;
+                    } else if (truncate_from == NULL_PAGE_ID && page_id != first_page_id_) {
+                        truncate_from = page_id;
+                    }
+                    page_id = vm_.GetNextPageId(page_id);
+                    continue;
+                }
+            }
+            auto page = buffer_pool_.GetPage(db_oid_, oid_, page_id, strategy.get());
+            std::unique_lock latch(page->GetLatch());
+            TablePage table_page(page);
+            PrunePage(table_page, page_id, oldest_xid, true);
+            db_size_t page_live_count = 0;
+            bool all_visible = true;
+            bool empty = true;
+            for (slotid_t slot_id = 0; slot_id < table_page.GetRecordCount(); slot_id++) {
+                if (!table_page.IsSlotUsed(slot_id)) {
+                    continue;
+                }
+                empty = false;
+                auto tuple = table_page.GetTupleView({page_id, slot_id}, column_list_);
+                if (tuple.IsDeleted()) {
+                    all_visible = false;
+                } else {
+                    page_live_count++;
+                    // 插入事务早于 oldest_xid 且未被回滚（回滚的插入记录带有删除标记），对之后开始的事务也可见
+                    all_visible = all_visible && tuple.GetXmin() < oldest_xid;
+                }
+            }
+            live_count += page_live_count;
+            if (all_visible) {
+                std::unique_lock lock(vm_mutex_);
+                vm_.Set(page_id, table_page.GetNextPageId(), page_live_count);
+            }
+            UpdateFreeSpace(page_id, table_page.GetFreeSpaceSize());
+            if (!empty) {
+                truncate_from = NULL_PAGE_ID;
+            } else if (truncate_from == NULL_PAGE_ID && page_id != first_page_id_) {
+                truncate_from = page_id;
+            }
+            page_id = table_page.GetNextPageId();
+        }
+        if (truncate_from != NULL_PAGE_ID) {
+            TruncatePages(truncate_from);
+        }
+        if (toast_ != nullptr) {
+            toast_->Vacuum(oldest_xid);
+        }
+        return live_count;
+    }
+
+    void Table::ForgetTruncatedPages(pageid_t page_count) {
+        if (last_page_id_ != NULL_PAGE_ID && last_page_id_ >= page_count) {
+            last_page_id_ = page_count - 1;
+        }
+        {
+            std::unique_lock lock(fsm_mutex_);
+            fsm_.Truncate(page_count);
+        }
+        {
+            // 保留的最后一个页面的下一页面已改变
+            std::unique_lock lock(vm_mutex_);
+            vm_.Truncate(page_count);
+            vm_.Clear(page_count - 1);
+        }
+        std::unique_lock lock(prune_mutex_);
+        for (auto iter = prune_candidates_.begin(); iter != prune_candidates_.end();) {
+            if (iter->first >= page_count) {
+                iter = prune_candidates_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    bool Table::IsAllVisible(pageid_t page_id) const {
+        std::unique_lock lock(vm_mutex_);
+        return vm_.IsAllVisible(page_id);
+    }
+
+    size_t Table::GetDeadTupleCount() const { return dead_tuples_; }
+
     pageid_t Table::GetFirstPageId() const { return first_page_id_; }
 
+    pageid_t Table::FindPageWithSpace(db_size_t size, xid_t oldest_xid, bool write_log) {
+        {
+            std::unique_lock lock(fsm_mutex_);
+            auto page_id = fsm_.Search(size);
+            if (page_id != NULL_PAGE_ID) {
+                return page_id;
+            }
+        }
+        auto page_id = PruneForSpace(size, oldest_xid, write_log);
+        if (page_id != NULL_PAGE_ID) {
+            return page_id;
+        }
+        return last_page_id_ == NULL_PAGE_ID ? first_page_id_.load() : last_page_id_.load();
+    }
+
+    pageid_t Table::PruneForSpace(db_size_t size, xid_t oldest_xid, bool write_log) {
+        std::vector<pageid_t> page_ids;
+        {
+            std::unique_lock lock(prune_mutex_);
+            for (const auto &[page_id, newest_xid]: prune_candidates_) {
+                if (newest_xid < oldest_xid) {
+                    page_ids.push_back(page_id);
+                }
+            }
+        }
+        for (auto page_id: page_ids) {
+            auto page = buffer_pool_.GetPage(db_oid_, oid_, page_id);
+            std::unique_lock latch(page->GetLatch());
+            TablePage table_page(page);
+            PrunePage(table_page, page_id, oldest_xid, write_log);
+            UpdateFreeSpace(page_id, table_page.GetFreeSpaceSize());
+            if (table_page.GetFreeSpaceSize() >= size) {
+                return page_id;
+            }
+        }
+        return NULL_PAGE_ID;
+    }
+
+    void Table::PrunePage(TablePage &table_page, pageid_t page_id, xid_t oldest_xid, bool write_log) {
+        auto dead_slots = table_page.GetDeadSlots(oldest_xid);
+        if (!dead_slots.empty()) {
+            ReclaimDeadTuples(dead_slots.size());
+            table_page.Compact(dead_slots);
+            if (write_log) {
+                auto lsn = log_manager_.AppendCompactPageLog(oid_, page_id, std::move(dead_slots));
+                table_page.SetPageLSN(lsn);
+            }
+        }
+        // 加锁期间页面中不会有新的删除，映射中的事务仍不晚于检查时的事务时说明删除记录已全部回收
+        std::unique_lock lock(prune_mutex_);
+        auto candidate = prune_candidates_.find(page_id);
+        if (candidate != prune_candidates_.end() && candidate->second < oldest_xid) {
+            prune_candidates_.erase(candidate);
+        }
+    }
+
+    void Table::TruncatePages(pageid_t page_count) {
+        auto page = buffer_pool_.GetPage(db_oid_, oid_, page_count - 1);
+        std::unique_lock latch(page->GetLatch());
+        TablePage table_page(page);
+        table_page.SetNextPageId(NULL_PAGE_ID);
+        auto lsn = log_manager_.AppendTruncateLog(oid_, page_count);
+        table_page.SetPageLSN(lsn);
+        // 截断无法撤销，日志先于截断落盘
+        log_manager_.Flush();
+        ForgetTruncatedPages(page_count);
+        buffer_pool_.TruncateFile(db_oid_, oid_, page_count);
+        // 磁盘上的最后一个页面带有截断日志的 LSN 时，说明文件已经截断，恢复时无需重做
+        buffer_pool_.WritePage(db_oid_, oid_, page_count - 1, *page);
+    }
+
+    void Table::AddDeadTuple(pageid_t page_id, xid_t xid) {
+        dead_tuples_++;
+        std::unique_lock lock(prune_mutex_);
+        auto &newest_xid = prune_candidates_.try_emplace(page_id, xid).first->second;
+        newest_xid = std::max(newest_xid, xid);
+    }
+
+    std::shared_ptr<Record> Table::ToastRecord(const std::shared_ptr<Record> &record, xid_t xid, cid_t cid,
+                                               bool write_log, xid_t oldest_xid) {
+        if (toast_ == nullptr) {
+            throw DbException("Record size too large: " + std::to_string(record->GetSize()));
+        }
+        return toast_->ToastRecord(*record, GetMaxRecordSize(buffer_pool_.GetPageSize()), xid, cid, write_log,
+                                   oldest_xid);
+    }
+
+    void Table::DeleteToastValues(const TablePage &table_page, const Rid &rid, xid_t xid, bool write_log) {
+        if (toast_ == nullptr) {
+            return;
+        }
+        auto tuple = table_page.GetTupleView(rid, column_list_);
+        for (auto i: column_list_.GetVarlenColumns()) {
+            if (auto *pointer = tuple.GetToastPointer(i)) {
+                toast_->DeleteValue(pointer, xid, write_log);
+            }
+        }
+    }
+
+    void Table::UpdateFreeSpace(pageid_t page_id, db_size_t free_space) {
+        std::unique_lock lock(fsm_mutex_);
+        fsm_.Update(page_id, free_space);
+    }
+
+    void Table::ClearAllVisible(pageid_t page_id) {
+        std::unique_lock lock(vm_mutex_);
+        vm_.Clear(page_id);
+    }
+
+    void Table::ReclaimDeadTuples(size_t count) {
+        auto dead_tuples = dead_tuples_.load();
+        while (!dead_tuples_.compare_exchange_weak(dead_tuples, dead_tuples - std::min(dead_tuples, count))) {
+        }
+    }
+
     oid_t Table::GetOid() const { return oid_; }
 
     oid_t Table::GetDbOid() const { return db_oid_; }
 
     const ColumnList &Table::GetColumnList() const { return column_list_; }
 
+    const ToastRelation *Table::GetToast() const { return toast_.get(); }
+
 }  // namespace huadb
@@ -1,10 +1,20 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "catalog/column_list.h"
 #include "common/types.h"
 #include "log/log_manager.h"
 #include "storage/buffer_pool.h"
+#include "table/free_space_map.h"
 #include "table/record.h"
+#include "table/table_page.h"
+#include "table/toast.h"
+#include "table/visibility_map.h"
 
 namespace huadb {
 
@@ -13,19 +23,46 @@ namespace huadb {
         Table(BufferPool &buffer_pool, LogManager &log_manager, oid_t oid, oid_t db_oid, ColumnList column_list,
               bool new_table, bool is_empty);
 
-        // 插入记录，返回插入记录的 rid
+        ~Table();
+
+        // 将空闲空间映射保存到磁盘，在关闭数据库或退出表所在数据库时调用
+        void SaveFreeSpaceMap();
+
+        // 插入记录，返回插入记录的 rid。超过页面可容纳长度的记录先将最长的字符串字段移入 TOAST 关系
         // write_log: 是否写日志。系统表操作不写日志，用户表操作写日志，lab 2 相关参数
-        Rid InsertRecord(const std::shared_ptr<Record>& record, xid_t xid, cid_t cid, bool write_log);
+        // oldest_xid: 早于该事务删除的记录可被回收，找不到空闲页面时先整理有这类记录的页面再扩展新页面，默认不回收
+        Rid InsertRecord(const std::shared_ptr<Record>& record, xid_t xid, cid_t cid, bool write_log,
+                         xid_t oldest_xid = DDL_XID);
+
+        // 批量插入记录，按顺序返回各记录的 rid
+        // 每个页面只获取并加锁一次，连续填满后再扩展新页面，一个页面中的多条记录只写一条 BulkInsertLog
+        std::vector<Rid> InsertRecords(const std::vector<std::shared_ptr<Record>> &records, xid_t xid, cid_t cid,
+                                       bool write_log, xid_t oldest_xid = DDL_XID);
 
         // 删除记录
         void DeleteRecord(const Rid &rid, xid_t xid, bool write_log);
 
-        // 更新记录
-        Rid UpdateRecord(const Rid &rid, xid_t xid, cid_t cid, const std::shared_ptr<Record>& record, bool write_log);
+        // 更新记录。新版本能放入旧版本所在页面时（必要时先回收页面中的删除记录）在页面内更新，只写一条 UpdateLog，
+        // 否则删除旧版本并按 InsertRecord 插入新版本
+        Rid UpdateRecord(const Rid &rid, xid_t xid, cid_t cid, const std::shared_ptr<Record>& record, bool write_log,
+                         xid_t oldest_xid = DDL_XID);
 
         // 用于系统表的原地更新，无需关注
         void UpdateRecordInPlace(const Record &record);
 
+        // 清理整张表：回收删除事务早于 oldest_xid 的记录，整理页面并更新空闲空间映射，返回表中未被删除的记录数
+        // 清理后表末尾连续的空页面从表文件中截断，调用者需保证清理期间没有其他语句访问该表
+        uint32_t Vacuum(xid_t oldest_xid);
+
+        // 表文件被截断为 page_count 个页面，丢弃内存中被截断页面的信息，也用于重做 TruncateLog
+        void ForgetTruncatedPages(pageid_t page_count);
+
+        // 页面是否全可见，全可见页面中的记录对所有事务均可见
+        bool IsAllVisible(pageid_t page_id) const;
+
+        // 已删除但尚未回收的记录数，重启后从 0 开始计数，用于判断是否需要自动清理
+        size_t GetDeadTupleCount() const;
+
         // 获取表的第一个页面的页面号
         pageid_t GetFirstPageId() const;
 
@@ -35,13 +72,62 @@ namespace huadb {
 
         const ColumnList &GetColumnList() const;
 
+        // 表的 TOAST 关系，系统表和 TOAST 关系自身没有，返回空指针
+        const ToastRelation *GetToast() const;
+
     private:
+        // 将过长记录的字段移入 TOAST 关系，表没有 TOAST 关系时抛出异常
+        std::shared_ptr<Record> ToastRecord(const std::shared_ptr<Record> &record, xid_t xid, cid_t cid, bool write_log,
+                                            xid_t oldest_xid);
+
+        // 删除页面中记录存放在 TOAST 关系中的字段。调用者持有页面的排他锁，之后再获取 TOAST 关系页面的锁
+        void DeleteToastValues(const TablePage &table_page, const Rid &rid, xid_t xid, bool write_log);
+
+        // 根据空闲空间映射选择插入的起始页面：映射中没有足够空间的页面时，先整理可回收空间的页面，
+        // 仍然没有时返回映射记录的最后一个页面，由调用者沿链表继续查找
+        pageid_t FindPageWithSpace(db_size_t size, xid_t oldest_xid, bool write_log);
+
+        // 依次整理删除事务均早于 oldest_xid 的页面，返回第一个整理后可以容纳 size 字节记录的页面，没有时返回 NULL_PAGE_ID
+        pageid_t PruneForSpace(db_size_t size, xid_t oldest_xid, bool write_log);
+
+        // 回收页面中删除事务早于 oldest_xid 的记录并整理页面。调用者持有页面的排他锁
+        void PrunePage(TablePage &table_page, pageid_t page_id, xid_t oldest_xid, bool write_log);
+
+        // 截断表末尾从 page_count 开始的空页面：先写日志并刷盘，再截断文件，最后将保留的最后一个页面写回磁盘
+        void TruncatePages(pageid_t page_count);
+
+        // 事务 xid 删除了页面中的一条记录，记入已删除记录数与待回收页面
+        void AddDeadTuple(pageid_t page_id, xid_t xid);
+
+        void UpdateFreeSpace(pageid_t page_id, db_size_t free_space);
+
+        // 页面被修改，不再全可见。调用者持有页面的排他锁
+        void ClearAllVisible(pageid_t page_id);
+
+        // 回收了 count 条删除记录，计数不会减到 0 以下
+        void ReclaimDeadTuples(size_t count);
+
+        // 从 records[next] 开始向页面中连续插入能放下的记录并写日志，返回第一条未插入记录的下标
+        size_t FillPage(TablePage &table_page, pageid_t page_id, const std::vector<std::shared_ptr<Record>> &records,
+                        size_t next, xid_t xid, cid_t cid, bool write_log, std::vector<Rid> &rids);
+
         BufferPool &buffer_pool_;
         LogManager &log_manager_;
         oid_t oid_;
         oid_t db_oid_;
-        pageid_t first_page_id_;  // 第一个页面的页面号
+        std::atomic<pageid_t> first_page_id_;  // 第一个页面的页面号
+        std::mutex first_page_mutex_;          // 保护空表第一个页面的创建
+        std::atomic<pageid_t> last_page_id_;   // 已知的最后一个页面，可能落后于实际末尾，扩展前沿链表找到真正的末尾
         ColumnList column_list_;  // 表的 schema 信息
+        FreeSpaceMap fsm_;        // 空闲空间映射，保存在表文件旁的 _fsm 文件中
+        std::mutex fsm_mutex_;
+        // 有被删除记录的页面到其中最新的删除事务的映射，该事务早于 oldest_xid 时页面中的删除记录均可回收
+        std::unordered_map<pageid_t, xid_t> prune_candidates_;
+        std::mutex prune_mutex_;
+        std::atomic<size_t> dead_tuples_ = 0;  // 已删除但尚未回收的记录数
+        VisibilityMap vm_;  // 可见性映射，页面的标记只在持有页面排他锁时修改
+        mutable std::mutex vm_mutex_;
+        std::unique_ptr<ToastRelation> toast_;  // 存放过长字段的 TOAST 关系
     };
 
 }  // namespace huadb
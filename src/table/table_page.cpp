@@ -1,4 +1,5 @@
 #include "table/table_page.h"
+#include <algorithm>
 #include <wchar.h>
 #include <cwchar>
 #include <ostream>
@@ -29,11 +30,11 @@ namespace huadb {
         *page_lsn_ = 0;
         *next_page_id_ = NULL_PAGE_ID;
         *lower_ = PAGE_HEADER_SIZE;
-        *upper_ = DB_PAGE_SIZE;
+        *upper_ = page_->GetSize();
         page_->SetDirty();
     }
 
-    slotid_t TablePage::InsertRecord(const std::shared_ptr<Record> &record, xid_t xid, cid_t cid) {
+    slotid_t TablePage::InsertRecord(const std::shared_ptr<Record> &record, xid_t xid, cid_t cid, bool reuse_slot) {
         // 在记录头添加事务信息（xid 和 cid）
         // LAB 3 BEGIN
         record->SetXmin(xid);
@@ -43,9 +44,19 @@ namespace huadb {
         // 将 record 写入 page data
         // 将 page 标记为 dirty
         // 返回插入的 slot id
-        auto slots_id = (*lower_ - PAGE_HEADER_SIZE) / sizeof(Slot);
+        auto slots_id = GetRecordCount();
+        if (reuse_slot) {
+            for (slotid_t i = 0; i < GetRecordCount(); i++) {
+                if (!IsSlotUsed(i)) {
+                    slots_id = i;
+                    break;
+                }
+            }
+        }
         *upper_ -= record->GetSize();
-        *lower_ += sizeof(Slot);
+        if (slots_id == GetRecordCount()) {
+            *lower_ += sizeof(Slot);
+        }
 
         Slot new_slot{
                 *upper_,
@@ -79,7 +90,7 @@ namespace huadb {
         page_->SetDirty();
     }
 
-    std::shared_ptr<Record> TablePage::GetRecord(Rid rid, const ColumnList &column_list) {
+    std::shared_ptr<Record> TablePage::GetRecord(Rid rid, const ColumnList &column_list, const ToastRelation *toast) {
         // 根据 slot_id 获取 record
         // 新建 record 并设置 rid
         auto slot_id = rid.slot_id_;
@@ -87,10 +98,14 @@ namespace huadb {
 
         auto record = std::make_shared<Record>();
         record->SetRid(rid);
-        record->DeserializeFrom(page_data_ + offset, column_list);
+        record->DeserializeFrom(page_data_ + offset, column_list, toast);
         return record;
     }
 
+    TupleView TablePage::GetTupleView(Rid rid, const ColumnList &column_list, const ToastRelation *toast) const {
+        return TupleView(page_data_ + slots_[rid.slot_id_].offset_, column_list, rid, toast);
+    }
+
     void TablePage::UndoDeleteRecord(slotid_t slot_id) {
         // 清除记录的删除标记
         // 将页面设为 dirty
@@ -110,7 +125,10 @@ namespace huadb {
         // 注意维护 lower 和 upper 指针，以及 slots 数组
         // 将页面设为 dirty
         *upper_ -= record_size;
-        *lower_ += sizeof(Slot);
+        // 插入时可能复用了空出的槽位
+        if (slot_id >= GetRecordCount()) {
+            *lower_ += sizeof(Slot);
+        }
 
         Slot new_slot{
                 page_offset,
@@ -126,6 +144,54 @@ namespace huadb {
 
     db_size_t TablePage::GetRecordCount() const { return (*lower_ - PAGE_HEADER_SIZE) / sizeof(Slot); }
 
+    bool TablePage::IsSlotUsed(slotid_t slot_id) const { return slots_[slot_id].size_ > 0; }
+
+    std::vector<slotid_t> TablePage::GetDeadSlots(xid_t oldest_xid) const {
+        std::vector<slotid_t> dead_slots;
+        for (slotid_t i = 0; i < GetRecordCount(); i++) {
+            if (!IsSlotUsed(i)) {
+                continue;
+            }
+            auto *record = page_data_ + slots_[i].offset_;
+            xid_t xmax;
+            memcpy(&xmax, record + sizeof(bool) + sizeof(xid_t), sizeof(xmax));
+            // 回滚删除会清除删除标记，仍被标记删除且早于 oldest_xid 的删除事务已提交
+            if (record[0] != 0 && xmax < oldest_xid) {
+                dead_slots.push_back(i);
+            }
+        }
+        return dead_slots;
+    }
+
+    void TablePage::Compact(const std::vector<slotid_t> &dead_slots) {
+        for (auto slot_id: dead_slots) {
+            slots_[slot_id] = {0, 0};
+        }
+        std::vector<slotid_t> live_slots;
+        for (slotid_t i = 0; i < GetRecordCount(); i++) {
+            if (IsSlotUsed(i)) {
+                live_slots.push_back(i);
+            }
+        }
+        // 按偏移从大到小移动，目标位置不小于原位置，不会覆盖尚未移动的记录
+        std::sort(live_slots.begin(), live_slots.end(),
+                  [&](slotid_t a, slotid_t b) { return slots_[a].offset_ > slots_[b].offset_; });
+        db_size_t upper = page_->GetSize();
+        for (auto slot_id: live_slots) {
+            auto &slot = slots_[slot_id];
+            upper -= slot.size_;
+            memmove(page_data_ + upper, page_data_ + slot.offset_, slot.size_);
+            slot.offset_ = upper;
+        }
+        *upper_ = upper;
+        while (GetRecordCount() > 0 && !IsSlotUsed(GetRecordCount() - 1)) {
+            *lower_ -= sizeof(Slot);
+        }
+        page_->SetDirty();
+    }
+
+    Slot TablePage::GetSlot(slotid_t slot_id) const { return slots_[slot_id]; }
+
     lsn_t TablePage::GetPageLSN() const { return *page_lsn_; }
 
     pageid_t TablePage::GetNextPageId() const { return *next_page_id_; }
@@ -167,9 +233,11 @@ namespace huadb {
         oss << "  slots: " << std::endl;
         for (size_t i = 0; i < GetRecordCount(); i++) {
             oss << "    " << i << ": offset " << slots_[i].offset_ << ", size " << slots_[i].size_ << " ";
-            if (slots_[i].size_ <= RECORD_HEADER_SIZE) {
+            if (!IsSlotUsed(i)) {
+                oss << "unused" << std::endl;
+            } else if (slots_[i].size_ <= RECORD_HEADER_SIZE) {
                 oss << "***Error: record size smaller than header size***" << std::endl;
-            } else if (slots_[i].offset_ + RECORD_HEADER_SIZE >= DB_PAGE_SIZE) {
+            } else if (slots_[i].offset_ + RECORD_HEADER_SIZE >= page_->GetSize()) {
                 oss << "***Error: record offset out of page boundary***" << std::endl;
             } else {
                 RecordHeader header;
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "common/types.h"
 #include "log/log_manager.h"
 #include "storage/page.h"
 #include "table/record.h"
+#include "table/tuple_view.h"
 
 namespace huadb {
 
@@ -23,7 +25,8 @@ namespace huadb {
         void Init();
 
         // 插入记录，返回插入的槽号
-        slotid_t InsertRecord(const std::shared_ptr<Record>& record, xid_t xid, cid_t cid);
+        // reuse_slot 为 true 时优先复用整理页面后空出的槽位，否则总是追加新槽位
+        slotid_t InsertRecord(const std::shared_ptr<Record>& record, xid_t xid, cid_t cid, bool reuse_slot = true);
 
         // 删除记录
         void DeleteRecord(slotid_t slot_id, xid_t xid);
@@ -31,8 +34,12 @@ namespace huadb {
         // 用于系统表的原地更新，无需关注
         void UpdateRecordInPlace(const Record &record, slotid_t slot_id);
 
-        // 获取记录
-        std::shared_ptr<Record> GetRecord(Rid rid, const ColumnList &column_list);
+        // 获取记录，toast 为表的 TOAST 关系，存放在其中的字段从中读出
+        std::shared_ptr<Record> GetRecord(Rid rid, const ColumnList &column_list,
+                                          const ToastRelation *toast = nullptr);
+
+        // 获取记录的只读视图，不拷贝记录
+        TupleView GetTupleView(Rid rid, const ColumnList &column_list, const ToastRelation *toast = nullptr) const;
 
         // Lab 2: 回滚删除操作
         void UndoDeleteRecord(slotid_t slot_id);
@@ -40,9 +47,22 @@ namespace huadb {
         // Lab 2: 重做插入操作
         void RedoInsertRecord(slotid_t slot_id, char *raw_record, db_size_t page_offset, db_size_t record_size);
 
-        // 获取记录数目
+        // 获取槽位数目，包括整理页面后空出的槽位
         db_size_t GetRecordCount() const;
 
+        // 槽位是否存放记录，整理页面后空出的槽位不存放记录
+        bool IsSlotUsed(slotid_t slot_id) const;
+
+        // 获取删除事务早于 oldest_xid 的记录所在的槽位，这些记录对所有事务均不可见
+        std::vector<slotid_t> GetDeadSlots(xid_t oldest_xid) const;
+
+        // 释放 dead_slots 中的记录，并将其余记录移动到页面末尾连续存放，空闲空间合并到 lower 与 upper 之间
+        // 记录的槽号不变，末尾的空槽位被收回。结果只取决于页面内容和 dead_slots，重做时得到相同的页面
+        void Compact(const std::vector<slotid_t> &dead_slots);
+
+        // 获取槽位
+        Slot GetSlot(slotid_t slot_id) const;
+
         // Lab 2: 获取 page lsn
         lsn_t GetPageLSN() const;
 
@@ -7,15 +7,15 @@
 
 namespace huadb {
 
-    bool IsVisible(IsolationLevel iso_level, xid_t xid, cid_t cid, const std::unordered_set<xid_t> &active_xids, const std::shared_ptr<Record>& record) {
+    bool IsVisible(IsolationLevel iso_level, xid_t xid, cid_t cid, const std::unordered_set<xid_t> &active_xids, const TupleView &record) {
         bool visible = true;
-        xid_t record_insert_xid = record->GetXmin();
-        xid_t record_delete_xid = record->GetXmax();
-        cid_t record_insert_cid = record->GetCid();
+        xid_t record_insert_xid = record.GetXmin();
+        xid_t record_delete_xid = record.GetXmax();
+        cid_t record_insert_cid = record.GetCid();
 
         if (iso_level == IsolationLevel::REPEATABLE_READ || iso_level == IsolationLevel::SERIALIZABLE) {
             // 删除
-            if (record->IsDeleted() && active_xids.find(record_delete_xid) == active_xids.end() && record_delete_xid <= xid) {
+            if (record.IsDeleted() && active_xids.find(record_delete_xid) == active_xids.end() && record_delete_xid <= xid) {
                 visible = false;
             }
             // 脏读 不可重复读
@@ -24,7 +24,7 @@ namespace huadb {
             }
         } else if (iso_level == IsolationLevel::READ_COMMITTED) {
             // 删除
-            if (record->IsDeleted() && (active_xids.find(record_delete_xid) == active_xids.end() || xid == record_delete_xid)) {
+            if (record.IsDeleted() && (active_xids.find(record_delete_xid) == active_xids.end() || xid == record_delete_xid)) {
                 visible = false;
             }
             // 脏读
@@ -40,10 +40,12 @@ namespace huadb {
     }
 
     TableScan::TableScan(BufferPool &buffer_pool, std::shared_ptr<Table> table, Rid rid)
-            : buffer_pool_(buffer_pool), table_(std::move(table)), rid_(rid) {}
+            : buffer_pool_(buffer_pool), table_(std::move(table)), rid_(rid),
+              strategy_(buffer_pool_.CreateScanStrategy(table_->GetDbOid(), table_->GetOid())) {}
 
     std::shared_ptr<Record> TableScan::GetNextRecord(xid_t xid, IsolationLevel isolation_level, cid_t cid,
-                                                     const std::unordered_set<xid_t> &active_xids) {
+                                                     const std::unordered_set<xid_t> &active_xids,
+                                                     const TupleVisitor &visitor) {
         // 根据事务隔离级别及活跃事务集合，判断记录是否可见
         // LAB 3 BEGIN
 
@@ -58,40 +60,74 @@ namespace huadb {
         std::shared_ptr<Record> record = nullptr;
 
         while (true) {
-            auto current_page = buffer_pool_.GetPage(table_->GetDbOid(), table_->GetOid(), rid_.page_id_);
+            auto current_page =
+                    buffer_pool_.GetPage(table_->GetDbOid(), table_->GetOid(), rid_.page_id_, strategy_.get());
+            std::shared_lock latch(current_page->GetLatch());
             TablePage table_page(current_page);
             if (rid_.slot_id_ < table_page.GetRecordCount()) {
-                record = table_page.GetRecord(rid_, table_ -> GetColumnList());
-                rid_.slot_id_ += 1;
-
-                // 加入可见性判断
-                if (!IsVisible(isolation_level, xid, cid, active_xids, record)) {
+                // 整理页面后空出的槽位不存放记录
+                if (!table_page.IsSlotUsed(rid_.slot_id_)) {
+                    rid_.slot_id_ += 1;
                     continue;
                 }
-                break;
-            }
-            // 切换页面
-            else if (table_page.GetNextPageId() != NULL_PAGE_ID) {
-                rid_.page_id_ = table_page.GetNextPageId();
-                rid_.slot_id_ = 0;
-                current_page = buffer_pool_.GetPage(table_->GetDbOid(), table_->GetOid(), rid_.page_id_);
-                new (&table_page) TablePage(current_page);
-
-                record = table_page.GetRecord(rid_, table_->GetColumnList());
+                // 先根据页面中的记录头判断可见性，不可见的记录无需反序列化
+                auto tuple = table_page.GetTupleView(rid_, table_->GetColumnList(), table_->GetToast());
                 rid_.slot_id_ += 1;
 
-                // 加入可见性判断
-                if (!IsVisible(isolation_level, xid, cid, active_xids, record)) {
+                // 加入可见性判断，全可见页面中的记录对所有事务均可见，无需逐条判断
+                if (rid_.page_id_ != vm_page_id_ || table_page.GetPageLSN() != vm_page_lsn_) {
+                    page_all_visible_ = table_->IsAllVisible(rid_.page_id_);
+                    vm_page_id_ = rid_.page_id_;
+                    vm_page_lsn_ = table_page.GetPageLSN();
+                }
+                if (!page_all_visible_ && !IsVisible(isolation_level, xid, cid, active_xids, tuple)) {
+                    continue;
+                }
+                record = visitor ? visitor(tuple) : tuple.Materialize();
+                if (record == nullptr) {
                     continue;
                 }
                 break;
             }
-            else {
+            // 切换页面
+            if (table_page.GetNextPageId() == NULL_PAGE_ID) {
                 rid_.page_id_ = NULL_PAGE_ID;
                 rid_.slot_id_ = 0;
                 return nullptr;
             }
+            if (table_page.GetNextPageId() == rid_.page_id_ + 1) {
+                sequential_pages_++;
+            } else {
+                sequential_pages_ = 0;
+            }
+            rid_.page_id_ = table_page.GetNextPageId();
+            rid_.slot_id_ = 0;
+            latch.unlock();
+            ReadAhead();
         }
         return record;
     }
+
+    void TableScan::ReadAhead() {
+        size_t read_ahead_pages = buffer_pool_.GetReadAheadPages();
+        if (read_ahead_pages == 0 || sequential_pages_ < READ_AHEAD_TRIGGER) {
+            return;
+        }
+        pageid_t start = rid_.page_id_ + 1;
+        if (prefetched_until_ != NULL_PAGE_ID && prefetched_until_ >= rid_.page_id_) {
+            // 已预读的页面还剩一半以上未扫描时不再预读
+            if (prefetched_until_ - rid_.page_id_ > read_ahead_pages / 2) {
+                return;
+            }
+            start = prefetched_until_ + 1;
+        }
+        std::vector<pageid_t> page_ids;
+        for (pageid_t page_id = start; page_id <= rid_.page_id_ + read_ahead_pages; page_id++) {
+            page_ids.push_back(page_id);
+        }
+        auto prefetched = buffer_pool_.PrefetchPages(table_->GetDbOid(), table_->GetOid(), page_ids, strategy_.get());
+        if (prefetched > 0) {
+            prefetched_until_ = page_ids[prefetched - 1];
+        }
+    }
 }  // namespace huadb
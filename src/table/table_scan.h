@@ -1,14 +1,24 @@
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <unordered_map>
 
 #include "common/types.h"
 #include "storage/buffer_pool.h"
 #include "table/record.h"
 #include "table/table.h"
+#include "table/tuple_view.h"
 
 namespace huadb {
 
+    // 连续多少次切换到相邻页面后判定为顺序扫描，开始预读
+    static constexpr size_t READ_AHEAD_TRIGGER = 2;
+
+    // 在页面中的可见记录上调用的回调，返回要输出的记录，返回空指针表示跳过该记录
+    // 回调执行期间页面被固定并持有读锁，视图只在回调内有效
+    using TupleVisitor = std::function<std::shared_ptr<Record>(const TupleView &)>;
+
     class TableScan {
     public:
         TableScan(BufferPool &buffer_pool, std::shared_ptr<Table> table, Rid rid);
@@ -18,14 +28,26 @@ namespace huadb {
         // cid: 事物内部 command id
         // active_xids: 活跃的事务 id 集合
         // 均为 Lab 3 相关参数
+        // visitor: 为空时物化完整记录，否则由 visitor 直接在页面上过滤、投影记录，只物化需要输出的记录
         std::shared_ptr<Record>
         GetNextRecord(xid_t xid = NULL_XID, IsolationLevel isolation_level = DEFAULT_ISOLATION_LEVEL,
-                      cid_t cid = NULL_CID, const std::unordered_set<xid_t> &active_xids = {});
+                      cid_t cid = NULL_CID, const std::unordered_set<xid_t> &active_xids = {},
+                      const TupleVisitor &visitor = nullptr);
 
     private:
+        // 顺序扫描时批量预读后续页面。页面按 page_id 连续分配，直接预读之后的 page_id，超出表末尾的页面读取失败后被忽略
+        void ReadAhead();
+
         BufferPool &buffer_pool_;
         std::shared_ptr<Table> table_;
         Rid rid_;  // 当前扫描到的记录的 rid
+        std::unique_ptr<BufferAccessStrategy> strategy_;  // 大表扫描使用的环形缓冲区，小表为空
+        size_t sequential_pages_ = 0;              // 连续切换到相邻页面的次数
+        pageid_t prefetched_until_ = NULL_PAGE_ID;  // 已预读的最大 page_id
+        // 最近读取的可见性映射标记及读取时页面的 page lsn。用户表的页面修改都会更新 page lsn，lsn 不变时标记仍然有效
+        pageid_t vm_page_id_ = NULL_PAGE_ID;
+        lsn_t vm_page_lsn_ = NULL_LSN;
+        bool page_all_visible_ = false;
     };
 
 }  // namespace huadb
@@ -0,0 +1,176 @@
+#include "table/toast.h"
+
+#include <cstring>
+
+#include "common/compression.h"
+#include "common/exceptions.h"
+#include "table/table.h"
+#include "table/table_page.h"
+
+namespace huadb {
+
+// 分片的列：下一个分片的页面号、槽号及分片数据，最后一个分片的下一个页面号为 NULL_PAGE_ID
+static constexpr size_t NEXT_PAGE_COLUMN = 0;
+static constexpr size_t NEXT_SLOT_COLUMN = 1;
+static constexpr size_t DATA_COLUMN = 2;
+
+void ToastPointer::SerializeTo(char *data) const {
+  size_t offset = 0;
+  memcpy(data + offset, &raw_size_, sizeof(raw_size_));
+  offset += sizeof(raw_size_);
+  memcpy(data + offset, &stored_size_, sizeof(stored_size_));
+  offset += sizeof(stored_size_);
+  memcpy(data + offset, &first_chunk_.page_id_, sizeof(first_chunk_.page_id_));
+  offset += sizeof(first_chunk_.page_id_);
+  memcpy(data + offset, &first_chunk_.slot_id_, sizeof(first_chunk_.slot_id_));
+}
+
+ToastPointer ToastPointer::DeserializeFrom(const char *data) {
+  ToastPointer pointer;
+  size_t offset = 0;
+  memcpy(&pointer.raw_size_, data + offset, sizeof(pointer.raw_size_));
+  offset += sizeof(pointer.raw_size_);
+  memcpy(&pointer.stored_size_, data + offset, sizeof(pointer.stored_size_));
+  offset += sizeof(pointer.stored_size_);
+  memcpy(&pointer.first_chunk_.page_id_, data + offset, sizeof(pointer.first_chunk_.page_id_));
+  offset += sizeof(pointer.first_chunk_.page_id_);
+  memcpy(&pointer.first_chunk_.slot_id_, data + offset, sizeof(pointer.first_chunk_.slot_id_));
+  return pointer;
+}
+
+ToastRelation::ToastRelation(BufferPool &buffer_pool, LogManager &log_manager, oid_t table_oid, oid_t db_oid)
+    : buffer_pool_(buffer_pool), log_manager_(log_manager), oid_(GetToastOid(table_oid)), db_oid_(db_oid) {
+  // 分片记录：记录头 + 空值位图 + 两个 uint + 字符串长度 + 数据
+  chunk_size_ = GetMaxRecordSize(buffer_pool_.GetPageSize()) - RECORD_HEADER_SIZE - 1 - 2 * sizeof(uint32_t) -
+                sizeof(db_size_t);
+}
+
+ToastRelation::~ToastRelation() = default;
+
+std::shared_ptr<Record> ToastRelation::ToastRecord(const Record &record, db_size_t max_size, xid_t xid, cid_t cid,
+                                                   bool write_log, xid_t oldest_xid) {
+  auto toasted = std::make_shared<Record>(record);
+  auto *chunk_table = GetChunkTable(true);
+  while (toasted->GetSize() > max_size) {
+    const auto &values = toasted->GetValues();
+    size_t col_idx = values.size();
+    for (size_t i = 0; i < values.size(); i++) {
+      if (values[i].IsNull() || !TypeUtil::IsString(values[i].GetType()) || toasted->IsToasted(i) ||
+          values[i].GetSize() <= ToastPointer::SIZE) {
+        continue;
+      }
+      if (col_idx == values.size() || values[i].GetSize() > values[col_idx].GetSize()) {
+        col_idx = i;
+      }
+    }
+    if (col_idx == values.size()) {
+      throw DbException("Record size too large: " + std::to_string(toasted->GetSize()));
+    }
+    auto value = toasted->GetValue(col_idx);
+    auto data = value.GetValue<std::string_view>();
+    auto compressed = Compression::Compress(data);
+    std::string_view stored = compressed.empty() ? data : std::string_view(compressed);
+
+    // 从最后一个分片开始插入，每个分片插入时已知下一个分片的位置
+    Rid next{NULL_PAGE_ID, 0};
+    size_t chunk_count = (stored.size() + chunk_size_ - 1) / chunk_size_;
+    for (size_t k = chunk_count; k > 0; k--) {
+      auto chunk = stored.substr((k - 1) * chunk_size_, chunk_size_);
+      std::vector<Value> chunk_values;
+      chunk_values.emplace_back(static_cast<uint32_t>(next.page_id_));
+      chunk_values.emplace_back(static_cast<uint32_t>(next.slot_id_));
+      chunk_values.emplace_back(chunk);
+      next = chunk_table->InsertRecord(std::make_shared<Record>(std::move(chunk_values)), xid, cid, write_log,
+                                       oldest_xid);
+    }
+    ToastPointer pointer{static_cast<uint32_t>(data.size()), static_cast<uint32_t>(stored.size()), next};
+    std::string pointer_data(ToastPointer::SIZE, '\0');
+    pointer.SerializeTo(pointer_data.data());
+    toasted->SetToastPointer(col_idx, pointer_data);
+  }
+  return toasted;
+}
+
+Value ToastRelation::Detoast(const char *pointer_data, Type type) const {
+  auto pointer = ToastPointer::DeserializeFrom(pointer_data);
+  auto *chunk_table = GetChunkTable(false);
+  if (chunk_table == nullptr) {
+    throw DbException("Toast relation " + std::to_string(oid_) + " does not exist");
+  }
+  std::string stored;
+  stored.reserve(pointer.stored_size_);
+  for (auto rid = pointer.first_chunk_; rid.page_id_ != NULL_PAGE_ID;) {
+    rid = ReadChunk(*chunk_table, rid, &stored);
+  }
+  if (stored.size() != pointer.stored_size_) {
+    throw DbException("Corrupted toast value");
+  }
+  if (pointer.stored_size_ < pointer.raw_size_) {
+    return Value(Compression::Decompress(stored, pointer.raw_size_), type);
+  }
+  return Value(stored, type);
+}
+
+void ToastRelation::DeleteValue(const char *pointer_data, xid_t xid, bool write_log) {
+  auto pointer = ToastPointer::DeserializeFrom(pointer_data);
+  auto *chunk_table = GetChunkTable(false);
+  if (chunk_table == nullptr) {
+    return;
+  }
+  for (auto rid = pointer.first_chunk_; rid.page_id_ != NULL_PAGE_ID;) {
+    auto next = ReadChunk(*chunk_table, rid, nullptr);
+    chunk_table->DeleteRecord(rid, xid, write_log);
+    rid = next;
+  }
+}
+
+void ToastRelation::Vacuum(xid_t oldest_xid) {
+  if (auto *chunk_table = GetChunkTable(false)) {
+    chunk_table->Vacuum(oldest_xid);
+  }
+}
+
+void ToastRelation::SaveFreeSpaceMap() {
+  std::unique_lock lock(mutex_);
+  if (chunk_table_ != nullptr) {
+    chunk_table_->SaveFreeSpaceMap();
+  }
+}
+
+Table *ToastRelation::GetChunkTable(bool create) const {
+  std::unique_lock lock(mutex_);
+  if (chunk_table_ != nullptr) {
+    return chunk_table_.get();
+  }
+  auto path = Disk::GetFilePath(db_oid_, oid_);
+  if (!Disk::FileExists(path) || Disk::EmptyFile(path)) {
+    if (!create) {
+      return nullptr;
+    }
+    // 创建文件时直接写入第一个页面，之后的分片均写日志。重启时文件总是非空，
+    // 不会因第一个页面只存在于重做后的缓存中而被误判为空表
+    Disk::CreateFile(path);
+    auto page = std::make_shared<Page>(buffer_pool_.GetPageSize());
+    TablePage(page).Init();
+    buffer_pool_.WritePage(db_oid_, oid_, 0, *page);
+  }
+  ColumnList column_list({ColumnDefinition("next_page", Type::UINT), ColumnDefinition("next_slot", Type::UINT),
+                          ColumnDefinition("data", Type::VARCHAR, chunk_size_)});
+  chunk_table_ = std::make_unique<Table>(buffer_pool_, log_manager_, oid_, db_oid_, std::move(column_list), false,
+                                         false);
+  return chunk_table_.get();
+}
+
+Rid ToastRelation::ReadChunk(Table &chunk_table, Rid rid, std::string *data) const {
+  auto page = buffer_pool_.GetPage(db_oid_, oid_, rid.page_id_);
+  std::shared_lock latch(page->GetLatch());
+  TablePage table_page(page);
+  auto tuple = table_page.GetTupleView(rid, chunk_table.GetColumnList());
+  if (data != nullptr) {
+    data->append(tuple.GetValue(DATA_COLUMN).GetValue<std::string_view>());
+  }
+  return {tuple.GetValue(NEXT_PAGE_COLUMN).GetValue<uint32_t>(),
+          static_cast<slotid_t>(tuple.GetValue(NEXT_SLOT_COLUMN).GetValue<uint32_t>())};
+}
+
+}  // namespace huadb
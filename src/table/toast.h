@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common/types.h"
+#include "common/value.h"
+#include "log/log_manager.h"
+#include "storage/buffer_pool.h"
+#include "table/record.h"
+
+namespace huadb {
+
+class Table;
+
+// TOAST 指针：字段的原长、存储长度（小于原长时字段经过压缩）及第一个分片的位置
+// 字段切分为多个分片存放在 TOAST 关系中，每个分片记录下一个分片的位置
+struct ToastPointer {
+  static constexpr db_size_t SIZE = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(pageid_t) + sizeof(slotid_t);
+
+  void SerializeTo(char *data) const;
+  static ToastPointer DeserializeFrom(const char *data);
+
+  uint32_t raw_size_;
+  uint32_t stored_size_;
+  Rid first_chunk_;
+};
+
+// 表的 TOAST 关系：记录超过页面可容纳的长度时，将最长的字符串字段压缩后切分为分片存放于此，记录中只保留 TOAST 指针
+// 分片与所属记录由同一事务插入、删除，分片的可见性由所属记录决定，读取时不判断；所属记录回收后分片随之被回收
+// 只在读取字段时才读取分片，查询未用到的字段不会被读取
+class ToastRelation {
+ public:
+  ToastRelation(BufferPool &buffer_pool, LogManager &log_manager, oid_t table_oid, oid_t db_oid);
+  ~ToastRelation();
+
+  // 依次将记录中最长的字符串字段移入 TOAST 关系，直到记录长度不超过 max_size，返回新的记录，原记录不变
+  // 所有字符串字段移出后仍然过长时抛出异常
+  std::shared_ptr<Record> ToastRecord(const Record &record, db_size_t max_size, xid_t xid, cid_t cid,
+                                      bool write_log, xid_t oldest_xid);
+
+  // 读取 TOAST 指针指向的字段
+  Value Detoast(const char *pointer, Type type) const;
+
+  // 删除 TOAST 指针指向的字段的所有分片
+  void DeleteValue(const char *pointer, xid_t xid, bool write_log);
+
+  // 回收删除事务早于 oldest_xid 的分片
+  void Vacuum(xid_t oldest_xid);
+
+  void SaveFreeSpaceMap();
+
+ private:
+  // 获取存放分片的表。TOAST 关系的文件在第一次移出字段时创建，文件不存在且 create 为 false 时返回空指针
+  Table *GetChunkTable(bool create) const;
+
+  // 读取一个分片，将分片数据追加到 data（非空时），返回下一个分片的位置
+  Rid ReadChunk(Table &chunk_table, Rid rid, std::string *data) const;
+
+  BufferPool &buffer_pool_;
+  LogManager &log_manager_;
+  oid_t oid_;
+  oid_t db_oid_;
+  db_size_t chunk_size_;  // 每个分片的最大数据长度，使分片记录恰好不超过页面可容纳的长度
+  mutable std::unique_ptr<Table> chunk_table_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,130 @@
+#include "table/tuple_view.h"
+
+#include <cstring>
+
+#include "common/exceptions.h"
+#include "table/record_header.h"
+#include "table/toast.h"
+
+namespace huadb {
+
+// 记录头布局：deleted(1) + xmin(4) + xmax(4) + cid(4)，与 RecordHeader::SerializeTo 一致
+static constexpr db_size_t XMIN_OFFSET = sizeof(bool);
+static constexpr db_size_t XMAX_OFFSET = XMIN_OFFSET + sizeof(xid_t);
+static constexpr db_size_t CID_OFFSET = XMAX_OFFSET + sizeof(xid_t);
+
+TupleView::TupleView(const char *data, const ColumnList &column_list, Rid rid, const ToastRelation *toast)
+    : data_(data), column_list_(column_list), rid_(rid), toast_(toast) {}
+
+bool TupleView::IsDeleted() const { return data_[0] != 0; }
+
+xid_t TupleView::GetXmin() const {
+  xid_t xmin;
+  memcpy(&xmin, data_ + XMIN_OFFSET, sizeof(xmin));
+  return xmin;
+}
+
+xid_t TupleView::GetXmax() const {
+  xid_t xmax;
+  memcpy(&xmax, data_ + XMAX_OFFSET, sizeof(xmax));
+  return xmax;
+}
+
+cid_t TupleView::GetCid() const {
+  cid_t cid;
+  memcpy(&cid, data_ + CID_OFFSET, sizeof(cid));
+  return cid;
+}
+
+bool TupleView::IsNull(size_t col_idx) const {
+  auto bits = reinterpret_cast<const uint8_t *>(data_ + RECORD_HEADER_SIZE);
+  return (bits[col_idx / 8] & (1U << (col_idx % 8))) != 0;
+}
+
+Value TupleView::GetValue(size_t col_idx) const {
+  if (col_idx >= column_list_.Length()) {
+    throw DbException("Column index out of range");
+  }
+  if (IsNull(col_idx)) {
+    return Value();
+  }
+  const auto &column = column_list_.GetColumn(col_idx);
+  if (auto *pointer = GetToastPointer(col_idx)) {
+    if (toast_ == nullptr) {
+      throw DbException("Toasted column without toast relation");
+    }
+    return toast_->Detoast(pointer, column.type_);
+  }
+  auto value = Value(column.type_, column.max_size_);
+  value.DeserializeFrom(data_ + GetColumnOffset(col_idx));
+  return value;
+}
+
+const char *TupleView::GetToastPointer(size_t col_idx) const {
+  if (IsNull(col_idx) || column_list_.IsFixedLength(col_idx)) {
+    return nullptr;
+  }
+  auto offset = GetColumnOffset(col_idx);
+  db_size_t str_size;
+  memcpy(&str_size, data_ + offset, sizeof(str_size));
+  return (str_size & TOAST_LENGTH_FLAG) ? data_ + offset + sizeof(str_size) : nullptr;
+}
+
+Rid TupleView::GetRid() const { return rid_; }
+
+std::shared_ptr<Record> TupleView::Materialize() const {
+  auto record = std::make_shared<Record>();
+  record->SetRid(rid_);
+  record->DeserializeFrom(data_, column_list_, toast_);
+  return record;
+}
+
+db_size_t TupleView::GetColumnOffset(size_t col_idx) const {
+  // 定长列在前、变长列在后。没有空值时定长列的偏移由列表预先算出，直接定位；
+  // 有空值时减去之前为空的定长列所占的长度
+  db_size_t bitmap_size = (column_list_.Length() + 7) / 8;
+  db_size_t offset = RECORD_HEADER_SIZE + bitmap_size;
+  bool has_null = false;
+  for (db_size_t i = 0; i < bitmap_size; i++) {
+    if (data_[RECORD_HEADER_SIZE + i] != 0) {
+      has_null = true;
+      break;
+    }
+  }
+  const auto &fixed_columns = column_list_.GetFixedColumns();
+  if (column_list_.IsFixedLength(col_idx)) {
+    offset += column_list_.GetLayoutPosition(col_idx);
+    if (has_null) {
+      for (auto i : fixed_columns) {
+        if (i >= col_idx) {
+          break;
+        }
+        if (IsNull(i)) {
+          offset -= column_list_.GetColumn(i).max_size_;
+        }
+      }
+    }
+    return offset;
+  }
+  offset += column_list_.GetFixedSize();
+  if (has_null) {
+    for (auto i : fixed_columns) {
+      if (IsNull(i)) {
+        offset -= column_list_.GetColumn(i).max_size_;
+      }
+    }
+  }
+  // 变长列依次跳过之前的非空变长列
+  const auto &varlen_columns = column_list_.GetVarlenColumns();
+  for (db_size_t k = 0; k < column_list_.GetLayoutPosition(col_idx); k++) {
+    if (IsNull(varlen_columns[k])) {
+      continue;
+    }
+    db_size_t str_size;
+    memcpy(&str_size, data_ + offset, sizeof(str_size));
+    offset += sizeof(str_size) + (str_size & ~TOAST_LENGTH_FLAG);
+  }
+  return offset;
+}
+
+}  // namespace huadb
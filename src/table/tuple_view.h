@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+
+#include "catalog/column_list.h"
+#include "common/value.h"
+#include "table/record.h"
+
+namespace huadb {
+
+class ToastRelation;
+
+// 页面中记录的只读视图，不拷贝记录，直接从页面缓冲区读取记录头、空值位图和单个列
+// 视图不持有页面，使用者需保证视图使用期间页面被固定并持有读锁
+// 存放在 TOAST 关系中的列只在读取该列时从 toast 中读出，未读取的列不会访问 TOAST 关系
+class TupleView {
+ public:
+  TupleView(const char *data, const ColumnList &column_list, Rid rid, const ToastRelation *toast = nullptr);
+
+  bool IsDeleted() const;
+  xid_t GetXmin() const;
+  xid_t GetXmax() const;
+  cid_t GetCid() const;
+
+  bool IsNull(size_t col_idx) const;
+  // 只解码第 col_idx 列，定长列直接定位，变长列跳过之前的变长列
+  Value GetValue(size_t col_idx) const;
+
+  // 第 col_idx 列存放在 TOAST 关系中时返回记录中的 TOAST 指针，否则返回空指针
+  const char *GetToastPointer(size_t col_idx) const;
+
+  Rid GetRid() const;
+
+  // 物化为完整的记录，记录离开扫描算子时使用
+  std::shared_ptr<Record> Materialize() const;
+
+ private:
+  // 第 col_idx 列在记录中的偏移，调用者保证该列非空
+  db_size_t GetColumnOffset(size_t col_idx) const;
+
+  const char *data_;
+  const ColumnList &column_list_;
+  Rid rid_;
+  const ToastRelation *toast_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,32 @@
+#include "table/visibility_map.h"
+
+namespace huadb {
+
+void VisibilityMap::Set(pageid_t page_id, pageid_t next_page_id, db_size_t record_count) {
+  if (page_id >= entries_.size()) {
+    entries_.resize(static_cast<size_t>(page_id) + 1);
+  }
+  entries_[page_id] = {true, next_page_id, record_count};
+}
+
+void VisibilityMap::Clear(pageid_t page_id) {
+  if (page_id < entries_.size()) {
+    entries_[page_id].all_visible_ = false;
+  }
+}
+
+void VisibilityMap::Truncate(pageid_t page_count) {
+  if (page_count < entries_.size()) {
+    entries_.resize(page_count);
+  }
+}
+
+bool VisibilityMap::IsAllVisible(pageid_t page_id) const {
+  return page_id < entries_.size() && entries_[page_id].all_visible_;
+}
+
+pageid_t VisibilityMap::GetNextPageId(pageid_t page_id) const { return entries_[page_id].next_page_id_; }
+
+db_size_t VisibilityMap::GetRecordCount(pageid_t page_id) const { return entries_[page_id].record_count_; }
+
+}  // namespace huadb
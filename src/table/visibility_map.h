@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "common/constants.h"
+#include "common/types.h"
+
+namespace huadb {
+
+// 可见性映射：记录表中哪些页面全可见，即页面中的记录均已提交、未被删除，且插入事务早于所有活跃事务及其快照
+// 全可见页面由 VACUUM 设置，页面中插入、删除记录或链接新页面时清除
+// 只保存在内存中，重启后所有页面均视为不全可见，由下一次 VACUUM 重新设置，故障恢复无需处理映射
+// 非线程安全，由 Table 加锁保护
+class VisibilityMap {
+ public:
+  // 将页面标记为全可见，并记录页面的下一个页面及记录数，VACUUM 跳过该页面时使用
+  void Set(pageid_t page_id, pageid_t next_page_id, db_size_t record_count);
+
+  void Clear(pageid_t page_id);
+
+  // 表文件被截断，丢弃页面号不小于 page_count 的页面的标记
+  void Truncate(pageid_t page_count);
+
+  bool IsAllVisible(pageid_t page_id) const;
+
+  // 全可见页面的下一个页面的页面号
+  pageid_t GetNextPageId(pageid_t page_id) const;
+
+  // 全可见页面的记录数
+  db_size_t GetRecordCount(pageid_t page_id) const;
+
+ private:
+  struct Entry {
+    bool all_visible_ = false;
+    pageid_t next_page_id_ = NULL_PAGE_ID;
+    db_size_t record_count_ = 0;
+  };
+  std::vector<Entry> entries_;  // 下标为页面号
+};
+
+}  // namespace huadb
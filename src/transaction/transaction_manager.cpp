@@ -1,4 +1,5 @@
 #include "transaction/transaction_manager.h"
+#include <algorithm>
 #include <string>
 #include "common/exceptions.h"
 
@@ -72,6 +73,17 @@ namespace huadb {
         return active_xids;
     }
 
+    xid_t TransactionManager::GetOldestXid() const {
+        xid_t oldest_xid = next_xid_;
+        for (const auto &[xid, active_xids]: xid2active_set_) {
+            oldest_xid = std::min(oldest_xid, xid);
+            for (auto active_xid: active_xids) {
+                oldest_xid = std::min(oldest_xid, active_xid);
+            }
+        }
+        return oldest_xid;
+    }
+
     void TransactionManager::ReleaseLocks(xid_t xid) { lock_manager_.ReleaseLocks(xid); }
 
 }  // namespace huadb